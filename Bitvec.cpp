@@ -98,16 +98,8 @@ void printbytes2 ( const void * blob, int len )
 //-----------------------------------------------------------------------------
 // Bit-level manipulation
 
-// These two are from the "Bit Twiddling Hacks" webpage
-
-uint32_t popcount ( uint32_t v )
-{
-	v = v - ((v >> 1) & 0x55555555);                    // reuse input as temporary
-	v = (v & 0x33333333) + ((v >> 2) & 0x33333333);     // temp
-	uint32_t c = ((v + ((v >> 4) & 0xF0F0F0F)) * 0x1010101) >> 24; // count
-
-	return c;
-}
+// parity() is from the "Bit Twiddling Hacks" webpage; popcount() and
+// popcount64() are inline in Bitvec.h
 
 uint32_t parity ( uint32_t v )
 {
@@ -182,11 +174,7 @@ void flipbit ( void * block, int len, uint32_t bit )
 
 int countbits ( uint32_t v )
 {
-  v = v - ((v >> 1) & 0x55555555);                    // reuse input as temporary
-  v = (v & 0x33333333) + ((v >> 2) & 0x33333333);     // temp
-  int c = ((v + ((v >> 4) & 0xF0F0F0F)) * 0x1010101) >> 24; // count
-
-  return c;
+  return (int)popcount(v);
 }
 
 //-----------------------------------------------------------------------------
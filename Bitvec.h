@@ -4,6 +4,10 @@
 
 #include <vector>
 
+#if defined(_MSC_VER)
+#include <intrin.h> // __popcnt, __popcnt64
+#endif
+
 //-----------------------------------------------------------------------------
 
 void     printbits   ( const void * blob, int len );
@@ -11,7 +15,6 @@ void     printhex32  ( const void * blob, int len );
 void     printbytes  ( const void * blob, int len );
 void     printbytes2 ( const void * blob, int len );
 
-uint32_t popcount    ( uint32_t v );
 uint32_t parity      ( uint32_t v );
 
 uint32_t getbit      ( const void * blob, int len, uint32_t bit );
@@ -31,6 +34,28 @@ int      countbits   ( const void * blob, int len );
 
 void     invert      ( std::vector<uint32_t> & v );
 
+//----------
+// Hardware popcount where the compiler has it (POPCNT with -mpopcnt or
+// -march=native), otherwise the compiler's own fallback
+
+inline uint32_t popcount ( uint32_t v )
+{
+#if defined(_MSC_VER)
+  return __popcnt(v);
+#else
+  return __builtin_popcount(v);
+#endif
+}
+
+inline uint32_t popcount64 ( uint64_t v )
+{
+#if defined(_MSC_VER)
+  return (uint32_t)__popcnt64(v);
+#else
+  return (uint32_t)__builtin_popcountll(v);
+#endif
+}
+
 //----------
 
 template< typename T >
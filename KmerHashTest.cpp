@@ -0,0 +1,42 @@
+#include <string.h>
+#include "Types.h"
+#include "kmerhash.h"
+
+// kmerHash64 is meant for keys of exactly 8 bytes (one packed k-mer); for
+// that length the result is kmerHash64(key, seed). Keys of any other length
+// start from a length-dependent state and are consumed 8 bytes at a time,
+// using the previous hash as the seed, with the last block zero-padded.
+void KmerHash64_test ( const void * key, int len, uint32_t seed, void * out )
+{
+  const uint8_t * data = (const uint8_t*)key;
+
+  if(len == 8)
+  {
+    uint64_t code;
+    memcpy(&code,data,8);
+    *(uint64_t*)out = kmerHash64(code,seed);
+    return;
+  }
+
+  // Using ~seed keeps the empty key from colliding with the 8-byte zero key
+  uint64_t h = kmerHash64(uint64_t(len),~uint64_t(seed));
+  int remaining = len;
+
+  while(remaining >= 8)
+  {
+    uint64_t block;
+    memcpy(&block,data,8);
+    h = kmerHash64(block,h);
+    data += 8;
+    remaining -= 8;
+  }
+
+  if(remaining > 0)
+  {
+    uint64_t block = 0;
+    memcpy(&block,data,remaining);
+    h = kmerHash64(block,h);
+  }
+
+  *(uint64_t*)out = h;
+}
@@ -24,6 +24,8 @@
 // slower than MD5.
 //
 
+#pragma once
+
 #include "Platform.h"
 #include <stddef.h>
 
@@ -0,0 +1,61 @@
+#include <algorithm>
+#include "abundance.h"
+#include "kmerhash.h"
+
+CountMinSketch::CountMinSketch(int logWidth, int depth)
+    : counters(size_t(depth) << logWidth, 0), depth(depth), mask((uint64_t(1) << logWidth) - 1) {}
+
+// Las posiciones de cada fila se derivan de un solo hash de 64 bits con
+// doble hashing (h1 + i * h2), evitando calcular un hash por fila
+uint32_t CountMinSketch::increment(uint64_t hashValue) {
+    uint64_t h1 = hashValue & 0xffffffff;
+    uint64_t h2 = (hashValue >> 32) | 1;
+    size_t width = size_t(mask) + 1;
+
+    uint8_t minimum = UINT8_MAX;
+    for (int i = 0; i < depth; ++i) {
+        minimum = std::min(minimum, counters[i * width + ((h1 + i * h2) & mask)]);
+    }
+    if (minimum == UINT8_MAX) return UINT8_MAX;  // Saturado
+
+    // Actualizacion conservadora
+    for (int i = 0; i < depth; ++i) {
+        uint8_t &counter = counters[i * width + ((h1 + i * h2) & mask)];
+        if (counter == minimum) ++counter;
+    }
+    return minimum + 1;
+}
+
+uint32_t CountMinSketch::count(uint64_t hashValue) const {
+    uint64_t h1 = hashValue & 0xffffffff;
+    uint64_t h2 = (hashValue >> 32) | 1;
+    size_t width = size_t(mask) + 1;
+
+    uint8_t minimum = UINT8_MAX;
+    for (int i = 0; i < depth; ++i) {
+        minimum = std::min(minimum, counters[i * width + ((h1 + i * h2) & mask)]);
+    }
+    return minimum;
+}
+
+void CountMinSketch::clear() {
+    std::fill(counters.begin(), counters.end(), 0);
+}
+
+AbundanceFilter::AbundanceFilter(uint32_t minCount, uint64_t expectedKmers)
+    : counts(logWidthFor(expectedKmers), depth), minCount(std::min<uint32_t>(minCount, UINT8_MAX)) {}
+
+int AbundanceFilter::logWidthFor(uint64_t expectedKmers) {
+    expectedKmers = std::min(expectedKmers, maxExpectedKmers);
+    int logWidth = 16;
+    while ((uint64_t(1) << logWidth) < 2 * expectedKmers) ++logWidth;
+    return logWidth;
+}
+
+// Una estimacion que ya paso el umbral sigue pasando: con filas muy ocupadas
+// la primera estimacion de un k-mer solido puede caer por encima de `minCount`
+bool AbundanceFilter::add(uint64_t code) {
+    // Semilla distinta a la de HyperLogLog::hashKmer para no correlacionar ambos
+    uint64_t hashValue = kmerHash64(code, 0x5851f42d4c957f2dULL);
+    return counts.increment(hashValue) >= minCount;
+}
@@ -0,0 +1,72 @@
+#ifndef ABUNDANCE_H
+#define ABUNDANCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Count-min sketch con contadores de 8 bits saturados y actualizacion
+// conservadora: solo se incrementan las filas que tienen el minimo, por lo que
+// la estimacion sobrecuenta menos y crece de a lo mas 1 por insercion.
+// La memoria es fija (depth * 2^logWidth bytes) sin importar cuantos k-mers
+// distintos tenga la entrada.
+class CountMinSketch {
+private:
+    std::vector<uint8_t> counters;
+    int depth;
+    uint64_t mask;
+
+public:
+    CountMinSketch(int logWidth, int depth);
+
+    // Incrementar el conteo del elemento y retornar la nueva estimacion
+    uint32_t increment(uint64_t hashValue);
+
+    // Estimar cuantas veces se ha visto el elemento
+    uint32_t count(uint64_t hashValue) const;
+
+    // Dejar todos los contadores en cero
+    void clear();
+
+    // Bytes de contadores
+    size_t memory() const { return counters.size(); }
+};
+
+// Filtro de abundancia que se pone delante de HyperLogLog::add: deja pasar
+// un k-mer cada vez que su conteo estimado es al menos `minCount` (insertarlo
+// de nuevo en el sketch no lo cambia). Asi los k-mers con errores de
+// secuenciacion (vistos pocas veces) no entran al sketch.
+//
+// El count-min se dimensiona con la cantidad esperada de k-mers distintos de
+// la muestra, contando los que tienen errores: cada una de sus `depth` filas
+// tiene la menor potencia de 2 de contadores que es al menos el doble, asi que
+// queda ocupada a lo mas a la mitad y un k-mer visto una vez pasa con -a 2 con
+// probabilidad <= (1 - e^(-1/2))^6 ~ 0.4%.
+class AbundanceFilter {
+private:
+    CountMinSketch counts;
+    uint32_t minCount;
+
+public:
+    static const int depth = 6;
+    static const uint64_t defaultExpectedKmers = 32000000;  // ~30x de un genoma bacteriano
+    static const uint64_t maxExpectedKmers = 1000000000;    // 6 filas de 2^31 contadores, 12 GB
+
+    explicit AbundanceFilter(uint32_t minCount, uint64_t expectedKmers = defaultExpectedKmers);
+
+    // log2 del ancho de cada fila para `expectedKmers` k-mers distintos
+    static int logWidthFor(uint64_t expectedKmers);
+
+    // Bytes de contadores para `expectedKmers` k-mers distintos
+    static size_t memoryFor(uint64_t expectedKmers) { return size_t(depth) << logWidthFor(expectedKmers); }
+
+    // Contar el k-mer (codificado a 2 bits por base); retorna true si debe
+    // insertarse en el sketch
+    bool add(uint64_t code);
+
+    void clear() { counts.clear(); }
+
+    size_t memory() const { return counts.memory(); }
+};
+
+#endif
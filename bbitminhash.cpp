@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cmath>
+#include "bbitminhash.h"
+#include "Bitvec.h"
+
+BBitMinHash::BBitMinHash(const MinHash &sketch, int b)
+    : b(b), slots(sketch.binCount()), wordsPerSlice((sketch.binCount() + 63) / 64),
+      words(wordsPerSlice * b, 0), density(0.0), emptySketch(sketch.empty()) {
+    if (emptySketch) return;
+    const std::vector<uint32_t> &signature = sketch.densifiedSignature();
+
+    double minimumSum = 0.0;
+    for (size_t i = 0; i < slots; ++i) {
+        uint32_t value = signature[i];
+        for (int j = 0; j < b; ++j) {
+            words[j * wordsPerSlice + i / 64] |= uint64_t((value >> j) & 1) << (i % 64);
+        }
+        minimumSum += value;
+    }
+
+    // El minimo de n valores uniformes en [0, 2^32) promedia 2^32 / (n + 1)
+    double meanMinimum = (minimumSum / slots + 1.0) / 4294967296.0;
+    density = std::min(1.0, std::max(0.0, 1.0 / meanMinimum - 1.0) / 4294967296.0);
+}
+
+bool BBitMinHash::matches(const BBitMinHash &other, size_t &equal) const {
+    if (other.b != b || other.slots != slots) return false;
+    equal = 0;
+    for (size_t w = 0; w < wordsPerSlice; ++w) {
+        uint64_t same = ~uint64_t(0);
+        for (int j = 0; j < b; ++j) {
+            size_t index = j * wordsPerSlice + w;
+            same &= ~(words[index] ^ other.words[index]);
+        }
+        // La ultima palabra puede tener posiciones de relleno
+        if (w == wordsPerSlice - 1 && slots % 64 != 0) same &= (uint64_t(1) << (slots % 64)) - 1;
+        equal += popcount64(same);
+    }
+    return true;
+}
+
+// A_{j,b} = r_j (1 - r_j)^(2^b - 1) / (1 - (1 - r_j)^(2^b)); con r_j -> 0 vale 2^-b
+static double collisionTerm(double r, int b) {
+    double values = std::ldexp(1.0, b);
+    if (r < 1e-9) return 1.0 / values;
+    if (r >= 1.0) return 0.0;
+    double logRest = std::log1p(-r);
+    return r * std::exp((values - 1.0) * logRest) / -std::expm1(values * logRest);
+}
+
+bool BBitMinHash::jaccard(const BBitMinHash &other, double &result) const {
+    size_t equal;
+    if (!matches(other, equal)) return false;
+    if (emptySketch || other.emptySketch) {
+        result = 0.0;
+        return true;
+    }
+    double matchRate = static_cast<double>(equal) / slots;
+
+    double r1 = density, r2 = other.density;
+    double a1 = collisionTerm(r1, b), a2 = collisionTerm(r2, b);
+    double c1 = (a1 * r2 + a2 * r1) / (r1 + r2);
+    double c2 = (a1 * r1 + a2 * r2) / (r1 + r2);
+
+    double estimate = (matchRate - c1) / (1.0 - c2);
+    result = std::min(1.0, std::max(0.0, estimate));
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef BBITMINHASH_H
+#define BBITMINHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "minhash.h"
+
+// MinHash de b bits (Li y Konig, 2010): de cada bin de la firma densificada
+// de un MinHash se guardan solo los b bits bajos, o sea s * b bits por genoma
+// en vez de s * 32. Los bits se guardan en rebanadas (bit-sliced): la
+// rebanada j tiene el bit j de todos los bins, empaquetado de a 64 bins por
+// palabra. Dos bins son iguales si coinciden en las b rebanadas, asi que una
+// comparacion es un AND de los XOR negados de cada rebanada y un popcount por
+// palabra, sin desempaquetar nada.
+//
+// Con b bits dos bins distintos coinciden por azar con probabilidad ~2^-b, y
+// la fraccion de coincidencias se corrige con la formula de Li y Konig, que
+// usa la fraccion del espacio de hashes de cada bin ocupada por cada genoma.
+// Solo se comparan firmas con el mismo b y la misma cantidad de bins: si no,
+// matches y jaccard retornan false.
+class BBitMinHash {
+private:
+    int b;
+    size_t slots;                 // Bins de la firma
+    size_t wordsPerSlice;
+    std::vector<uint64_t> words;  // Rebanada j en [j * wordsPerSlice, (j + 1) * wordsPerSlice)
+    double density;               // Elementos por bin / 2^32 (r de Li y Konig)
+    bool emptySketch;
+
+public:
+    // Guardar `b` bits por bin de `sketch` (1 <= b <= 32)
+    BBitMinHash(const MinHash &sketch, int b);
+
+    int bitsPerSlot() const { return b; }
+
+    size_t memoryBytes() const { return words.size() * sizeof(uint64_t); }
+
+    // Bins iguales en los b bits (mismo b y misma cantidad de bins)
+    bool matches(const BBitMinHash &other, size_t &equal) const;
+
+    // Jaccard con la correccion por coincidencias al azar
+    bool jaccard(const BBitMinHash &other, double &result) const;
+};
+
+#endif
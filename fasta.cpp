@@ -0,0 +1,79 @@
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "fasta.h"
+
+// Mapear el archivo completo; el kernel carga las paginas a medida que se leen
+MappedFile::MappedFile(const std::string &filename) : buffer(nullptr), length(0), opened(false) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+        length = static_cast<size_t>(st.st_size);
+        if (length == 0) {
+            opened = true;  // Archivo vacio: no hay nada que mapear
+        } else {
+            void *addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                // La lectura es secuencial, pedimos read-ahead agresivo
+                madvise(addr, length, MADV_SEQUENTIAL);
+                buffer = static_cast<const char *>(addr);
+                opened = true;
+            } else {
+                length = 0;
+            }
+        }
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (buffer != nullptr) {
+        munmap(const_cast<char *>(buffer), length);
+    }
+}
+
+FastaScanner::FastaScanner(const char *data, size_t size) : data(data), size(size), pos(0) {}
+
+// Lee el siguiente registro registrando cada linea de secuencia como un tramo.
+// Los retornos de carro ('\r') al final de linea se excluyen del tramo.
+bool FastaScanner::next(FastaRecord &record) {
+    record.headerOffset = pos;
+    record.headerLength = 0;
+    record.segments.clear();
+
+    bool started = false;
+    while (pos < size) {
+        const char *line = data + pos;
+        const char *newline = static_cast<const char *>(std::memchr(line, '\n', size - pos));
+        size_t lineLength = newline ? static_cast<size_t>(newline - line) : size - pos;
+        size_t nextPos = pos + lineLength + (newline ? 1 : 0);
+
+        if (lineLength > 0 && line[lineLength - 1] == '\r') {
+            --lineLength;
+        }
+
+        if (lineLength > 0 && line[0] == '>') {
+            if (started) break;  // Comienza el siguiente registro
+            record.headerOffset = pos;
+            record.headerLength = lineLength - 1;
+            started = true;
+        } else if (lineLength > 0) {
+            SequenceSegment segment = { line, lineLength };
+            record.segments.push_back(segment);
+            started = true;
+        }
+
+        pos = nextPos;
+    }
+
+    return started;
+}
+
+std::string FastaScanner::header(const FastaRecord &record) const {
+    if (record.headerLength == 0) return std::string();
+    return std::string(data + record.headerOffset + 1, record.headerLength);
+}
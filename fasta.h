@@ -0,0 +1,139 @@
+#ifndef FASTA_H
+#define FASTA_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Tramo contiguo de secuencia dentro del archivo (una linea sin el salto)
+struct SequenceSegment {
+    const char *data;
+    size_t length;
+};
+
+// Registro FASTA como vista sobre el archivo mapeado: no se copia la secuencia,
+// solo se guardan los tramos entre saltos de linea
+struct FastaRecord {
+    size_t headerOffset;  // Posicion del '>' dentro del archivo
+    size_t headerLength;  // Largo del encabezado sin '>' ni salto de linea
+    std::vector<SequenceSegment> segments;
+};
+
+// Archivo de solo lectura mapeado en memoria con mmap
+class MappedFile {
+private:
+    const char *buffer;
+    size_t length;
+    bool opened;
+
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+public:
+    explicit MappedFile(const std::string &filename);
+    ~MappedFile();
+
+    bool isOpen() const { return opened; }
+    const char *data() const { return buffer; }
+    size_t size() const { return length; }
+};
+
+// Recorre los registros de un buffer FASTA entregandolos como vistas
+class FastaScanner {
+private:
+    const char *data;
+    size_t size;
+    size_t pos;
+
+public:
+    FastaScanner(const char *data, size_t size);
+
+    // Avanza al siguiente registro; retorna false al llegar al final
+    bool next(FastaRecord &record);
+
+    // Copia el encabezado de un registro (solo se usa para reportar)
+    std::string header(const FastaRecord &record) const;
+};
+
+// Analizador FASTA incremental para entradas que llegan por bloques (por
+// ejemplo desde GzipReader), donde una linea puede quedar cortada entre dos
+// bloques. Por cada registro llama a handler.beginRecord(encabezado), luego a
+// handler.sequence(datos, largo) por cada tramo de linea y finalmente a
+// handler.endRecord(), que retorna false para detener la lectura.
+template <typename Handler>
+class FastaStreamParser {
+private:
+    Handler &handler;
+    std::string header;
+    bool atLineStart;
+    bool inHeader;
+    bool inRecord;
+    bool stopped;
+
+public:
+    explicit FastaStreamParser(Handler &handler)
+        : handler(handler), atLineStart(true), inHeader(false), inRecord(false), stopped(false) {}
+
+    // Procesar un bloque; retorna false si el handler pidio detenerse
+    bool feed(const char *data, size_t length) {
+        size_t i = 0;
+        while (i < length && !stopped) {
+            const char *newline = static_cast<const char *>(std::memchr(data + i, '\n', length - i));
+            size_t end = newline ? static_cast<size_t>(newline - data) : length;
+
+            if (inHeader) {
+                header.append(data + i, end - i);
+                if (newline) {
+                    if (!header.empty() && header[header.size() - 1] == '\r') {
+                        header.erase(header.size() - 1);
+                    }
+                    handler.beginRecord(header);
+                    inHeader = false;
+                }
+            } else if (atLineStart && data[i] == '>') {
+                if (inRecord && !handler.endRecord()) {
+                    stopped = true;
+                    break;
+                }
+                inRecord = true;
+                inHeader = true;
+                header.clear();
+                ++i;
+                continue;
+            } else {
+                // Tramo de secuencia; un '\r' nunca es una base valida
+                size_t segmentEnd = end;
+                if (segmentEnd > i && data[segmentEnd - 1] == '\r') --segmentEnd;
+                if (segmentEnd > i) {
+                    if (!inRecord) {
+                        handler.beginRecord(std::string());
+                        inRecord = true;
+                    }
+                    handler.sequence(data + i, segmentEnd - i);
+                }
+            }
+
+            atLineStart = newline != nullptr;
+            i = newline ? end + 1 : length;
+        }
+        return !stopped;
+    }
+
+    // Cerrar el ultimo registro al terminar la entrada. Siempre retorna true:
+    // en FASTA cualquier final es valido (ver FastqStreamParser::finish)
+    bool finish() {
+        if (stopped) return true;
+        if (inHeader) {
+            handler.beginRecord(header);
+            inHeader = false;
+        }
+        if (inRecord) {
+            handler.endRecord();
+            inRecord = false;
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef FASTQ_H
+#define FASTQ_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+// Analizador FASTQ incremental con la misma interfaz de handler que
+// FastaStreamParser: cada lectura es un registro con beginRecord(nombre),
+// sequence(datos, largo) y endRecord(). Supone el formato de cuatro lineas
+// por lectura (nombre, secuencia, '+', calidades); las calidades se saltan
+// sin copiarlas. Como en FastaStreamParser, un '\r' al final de una linea se
+// descarta, asi que las lineas en blanco entre lecturas pueden ser "\n" o
+// "\r\n". Una linea de separacion que no empieza con '+' o una lectura
+// incompleta al final de la entrada se reportan como error.
+template <typename Handler>
+class FastqStreamParser {
+private:
+    Handler &handler;
+    std::string header;
+    int line;        // Linea actual dentro de la lectura (0 a 3)
+    bool inLine;     // La linea actual ya empezo en un bloque anterior
+    bool hasMarker;  // La linea de nombre actual empieza con '@'
+    bool stopped;
+    bool malformed;
+
+public:
+    explicit FastqStreamParser(Handler &handler)
+        : handler(handler), line(0), inLine(false), hasMarker(false), stopped(false), malformed(false) {}
+
+    // Procesar un bloque; retorna false si el handler pidio detenerse o el
+    // formato es invalido
+    bool feed(const char *data, size_t length) {
+        size_t i = 0;
+        while (i < length && !stopped) {
+            const char *newline = static_cast<const char *>(std::memchr(data + i, '\n', length - i));
+            size_t end = newline ? static_cast<size_t>(newline - data) : length;
+
+            if (line == 0) {
+                if (!inLine) {
+                    header.clear();
+                    hasMarker = data[i] == '@';
+                    if (hasMarker) ++i;
+                }
+                header.append(data + i, end - i);
+                if (newline) {
+                    if (!header.empty() && header[header.size() - 1] == '\r') {
+                        header.erase(header.size() - 1);
+                    }
+                    // Saltar lineas en blanco entre lecturas
+                    if (!hasMarker && header.empty()) {
+                        inLine = false;
+                        i = end + 1;
+                        continue;
+                    }
+                    handler.beginRecord(header);
+                }
+            } else if (line == 1) {
+                size_t segmentEnd = end;
+                if (segmentEnd > i && data[segmentEnd - 1] == '\r') --segmentEnd;
+                if (segmentEnd > i) {
+                    handler.sequence(data + i, segmentEnd - i);
+                }
+            } else if (line == 2 && !inLine && data[i] != '+') {
+                malformed = true;
+                stopped = true;
+                break;
+            } else if (line == 3 && newline) {
+                if (!handler.endRecord()) stopped = true;
+            }
+
+            inLine = newline == nullptr;
+            if (newline) line = (line + 1) & 3;
+            i = newline ? end + 1 : length;
+        }
+        return !stopped;
+    }
+
+    // Cerrar la ultima lectura si el archivo no termina en salto de linea.
+    // Retorna false si el formato era invalido o la ultima lectura quedo
+    // incompleta (le faltan lineas).
+    bool finish() {
+        if (malformed) return false;
+        if (stopped) return true;
+        bool complete = true;
+        if (line == 3 && inLine) {
+            handler.endRecord();
+        } else if (line != 0 || (inLine && (hasMarker || !isBlank(header)))) {
+            complete = false;
+        }
+        line = 0;
+        inLine = false;
+        return complete;
+    }
+
+private:
+    // Resto de una linea en blanco que termino sin salto de linea
+    static bool isBlank(const std::string &text) { return text.empty() || text == "\r"; }
+};
+
+#endif
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include "fracminhash.h"
+#include "intersection.h"
+
+// Lectura secuencial de los hashes codificados
+class DeltaReader {
+private:
+    const uint8_t *position;
+    const uint8_t *end;
+
+public:
+    uint64_t value;
+
+    explicit DeltaReader(const std::vector<uint8_t> &encoded)
+        : position(encoded.data()), end(encoded.data() + encoded.size()), value(0) {}
+
+    // Avanzar al siguiente hash; false al terminar
+    bool next() {
+        if (position == end) return false;
+        uint64_t delta = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+            byte = *position++;
+            delta |= uint64_t(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        value += delta;
+        return true;
+    }
+};
+
+static void appendVarint(std::vector<uint8_t> &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Codificar hashes ordenados y sin repetir
+static void encodeSorted(const std::vector<uint64_t> &hashes, std::vector<uint8_t> &out) {
+    out.clear();
+    uint64_t previous = 0;
+    for (uint64_t hashValue : hashes) {
+        appendVarint(out, hashValue - previous);
+        previous = hashValue;
+    }
+}
+
+FracMinHash::FracMinHash(uint64_t scaled)
+    : scaled(scaled), threshold(scaled <= 1 ? ~uint64_t(0) : ~uint64_t(0) / scaled), count(0) {}
+
+void FracMinHash::finish() {
+    if (pending.empty()) return;
+    sortUnique(pending);
+
+    // Mezclar los hashes guardados con los nuevos
+    std::vector<uint64_t> merged;
+    merged.reserve(count + pending.size());
+    DeltaReader reader(encoded);
+    size_t i = 0;
+    bool more = reader.next();
+    while (more || i < pending.size()) {
+        if (!more || (i < pending.size() && pending[i] < reader.value)) {
+            merged.push_back(pending[i++]);
+        } else {
+            if (i < pending.size() && pending[i] == reader.value) ++i;
+            merged.push_back(reader.value);
+            more = reader.next();
+        }
+    }
+
+    encodeSorted(merged, encoded);
+    count = merged.size();
+    pending.clear();
+}
+
+bool FracMinHash::merge(const FracMinHash &other) {
+    if (other.scaled != scaled) return false;
+    if (&other == this) return true;
+    DeltaReader reader(other.encoded);
+    while (reader.next()) {
+        pending.push_back(reader.value);
+    }
+    pending.insert(pending.end(), other.pending.begin(), other.pending.end());
+    finish();
+    return true;
+}
+
+// Las consultas sobre un sketch sin terminar usan una copia terminada, para
+// no modificar un sketch que otro hilo puede estar leyendo
+static FracMinHash finishedCopy(const FracMinHash &sketch) {
+    FracMinHash copy(sketch);
+    copy.finish();
+    return copy;
+}
+
+uint64_t FracMinHash::size() const {
+    if (!finished()) return finishedCopy(*this).size();
+    return count;
+}
+
+size_t FracMinHash::memoryBytes() const {
+    if (!finished()) return finishedCopy(*this).memoryBytes();
+    return encoded.size();
+}
+
+bool FracMinHash::sharedCount(const FracMinHash &other, uint64_t &shared) const {
+    if (other.scaled != scaled) return false;
+    if (!finished()) return finishedCopy(*this).sharedCount(other, shared);
+    if (!other.finished()) return sharedCount(finishedCopy(other), shared);
+    DeltaReader a(encoded), b(other.encoded);
+    shared = 0;
+    bool moreA = a.next(), moreB = b.next();
+    while (moreA && moreB) {
+        if (a.value < b.value) {
+            moreA = a.next();
+        } else if (b.value < a.value) {
+            moreB = b.next();
+        } else {
+            ++shared;
+            moreA = a.next();
+            moreB = b.next();
+        }
+    }
+    return true;
+}
+
+bool FracMinHash::jaccard(const FracMinHash &other, double &result) const {
+    uint64_t shared;
+    if (!sharedCount(other, shared)) return false;
+    uint64_t unionSize = size() + other.size() - shared;
+    result = unionSize > 0 ? static_cast<double>(shared) / unionSize : 0.0;
+    return true;
+}
+
+bool FracMinHash::containment(const FracMinHash &other, double &result) const {
+    uint64_t shared;
+    if (!sharedCount(other, shared)) return false;
+    uint64_t own = size();
+    result = own > 0 ? static_cast<double>(shared) / own : 0.0;
+    return true;
+}
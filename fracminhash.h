@@ -0,0 +1,84 @@
+#ifndef FRACMINHASH_H
+#define FRACMINHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "kmer128.h"
+#include "kmerhash.h"
+
+// Sketch FracMinHash (scaled MinHash): guarda el hash de 64 bits de cada k-mer
+// distinto que cae bajo 2^64 / scaled, o sea una fraccion 1 / scaled de los
+// k-mers elegida por su hash y no por su posicion. Dos sketches con el mismo
+// scaled muestrean los mismos k-mers, asi que se fusionan con una union y la
+// interseccion de los sketches es una muestra de la interseccion de los
+// conjuntos: sirven para Jaccard y para contencion aunque los tamaños sean
+// muy distintos. El tamaño crece con el genoma (~n / scaled hashes) en vez de
+// los 2^18 registros fijos del HyperLogLog.
+//
+// Los k-mers se hashean con kmerHash64, el mismo hash que la politica por
+// defecto del HyperLogLog trunca a 32 bits. Los hashes se guardan ordenados y
+// codificados como diferencias con el anterior en varint (7 bits por byte), y
+// se comparan decodificando ambos sketches en una sola mezcla lineal. Los
+// hashes nuevos se juntan en un buffer que se incorpora al llegar a su tamaño
+// o con finish().
+//
+// Sketches con distinto scaled no muestrean los mismos k-mers: merge y las
+// comparaciones retornan false sin tocar nada si los scaled no coinciden.
+//
+// Las consultas (metodos const) no modifican el sketch, asi que varios hilos
+// pueden consultar el mismo a la vez; agregar hashes o fusionar no es seguro
+// en paralelo con nada. Hay que llamar a finish() despues del ultimo k-mer:
+// si quedan hashes en el buffer cada consulta trabaja sobre una copia
+// terminada, lo que es correcto pero lento.
+class FracMinHash {
+private:
+    uint64_t scaled;
+    uint64_t threshold;              // 2^64 / scaled
+    std::vector<uint8_t> encoded;    // Diferencias en varint
+    uint64_t count;                  // Hashes en `encoded`
+    std::vector<uint64_t> pending;   // Hashes sin incorporar
+
+public:
+    explicit FracMinHash(uint64_t scaled = 1000);
+
+    void addHash(uint64_t hashValue) {
+        if (hashValue >= threshold) return;
+        pending.push_back(hashValue);
+        if (pending.size() >= 4096 && pending.size() >= count) finish();
+    }
+
+    void addKmer(uint64_t code) { addHash(kmerHash64(code)); }
+
+    void addKmer(const Kmer128 &kmer) { addHash(hashKmer128(kmer)); }
+
+    // Incorporar los hashes del buffer
+    void finish();
+
+    bool finished() const { return pending.empty(); }
+
+    // Unir con un sketch del mismo scaled
+    bool merge(const FracMinHash &other);
+
+    uint64_t scale() const { return scaled; }
+
+    // Hashes distintos guardados
+    uint64_t size() const;
+
+    // Bytes de los hashes codificados
+    size_t memoryBytes() const;
+
+    // Cantidad estimada de k-mers distintos
+    double estimate() const { return static_cast<double>(size()) * scaled; }
+
+    // Jaccard con `other` (mismo scaled)
+    bool jaccard(const FracMinHash &other, double &result) const;
+
+    // Fraccion de los k-mers de este sketch que estan en `other`
+    bool containment(const FracMinHash &other, double &result) const;
+
+    // Hashes compartidos con `other`
+    bool sharedCount(const FracMinHash &other, uint64_t &shared) const;
+};
+
+#endif
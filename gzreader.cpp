@@ -0,0 +1,101 @@
+#include <cstdio>
+#include <zlib.h>
+#include "gzreader.h"
+
+GzipReader::GzipReader(const std::string &filename, size_t chunkSize, size_t depth)
+    : slots(depth, std::vector<char>(chunkSize)), sizes(depth, 0),
+      head(0), tail(0), count(0), holding(false),
+      finished(false), stopping(false), failed(false), opened(false) {
+    gzFile file = gzopen(filename.c_str(), "rb");
+    if (file == nullptr) return;
+
+    // Buffer interno de zlib del mismo tamaño que los bloques
+    gzbuffer(file, static_cast<unsigned>(chunkSize));
+    opened = true;
+    worker = std::thread(&GzipReader::decompress, this, static_cast<void *>(file));
+}
+
+GzipReader::~GzipReader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    notFull.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+// Hilo productor: llena bloques libres del buffer circular
+void GzipReader::decompress(void *handle) {
+    gzFile file = static_cast<gzFile>(handle);
+
+    for (;;) {
+        size_t slot;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notFull.wait(lock, [this] { return count < slots.size() || stopping; });
+            if (stopping) break;
+            slot = tail;
+        }
+
+        // El bloque `slot` no es visible para el consumidor mientras se llena
+        int bytes = gzread(file, slots[slot].data(), static_cast<unsigned>(slots[slot].size()));
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bytes < 0) {
+            failed = true;
+            break;
+        }
+        if (bytes == 0) break;
+
+        sizes[slot] = static_cast<size_t>(bytes);
+        tail = (tail + 1) % slots.size();
+        ++count;
+        notEmpty.notify_one();
+    }
+
+    gzclose(file);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    finished = true;
+    notEmpty.notify_one();
+}
+
+bool GzipReader::next(const char *&data, size_t &length) {
+    if (!opened) return false;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // Devolver el bloque anterior al productor
+    if (holding) {
+        head = (head + 1) % slots.size();
+        --count;
+        holding = false;
+        notFull.notify_one();
+    }
+
+    notEmpty.wait(lock, [this] { return count > 0 || finished; });
+    if (count == 0) return false;
+
+    data = slots[head].data();
+    length = sizes[head];
+    holding = true;
+    return true;
+}
+
+bool GzipReader::hasError() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return failed;
+}
+
+bool GzipReader::isGzipFile(const std::string &filename) {
+    FILE *file = std::fopen(filename.c_str(), "rb");
+    if (file == nullptr) return false;
+
+    unsigned char magic[2] = { 0, 0 };
+    size_t bytes = std::fread(magic, 1, 2, file);
+    std::fclose(file);
+
+    return bytes == 2 && magic[0] == 0x1f && magic[1] == 0x8b;
+}
@@ -0,0 +1,55 @@
+#ifndef GZREADER_H
+#define GZREADER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Lector de archivos .gz que descomprime en un hilo propio. Los bloques
+// descomprimidos se entregan al consumidor a traves de un buffer circular
+// acotado de `depth` bloques de `chunkSize` bytes, asi la descompresion se
+// solapa con el procesamiento de k-mers y la memoria usada es fija.
+class GzipReader {
+private:
+    std::vector<std::vector<char> > slots;
+    std::vector<size_t> sizes;
+    size_t head;      // Siguiente bloque a consumir
+    size_t tail;      // Siguiente bloque a llenar
+    size_t count;     // Bloques llenos en el buffer
+    bool holding;     // El consumidor tiene un bloque prestado
+    bool finished;    // El productor llego al final del archivo
+    bool stopping;    // El consumidor pidio detener la lectura
+    bool failed;      // zlib reporto un error
+    bool opened;
+
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::thread worker;
+
+    void decompress(void *file);
+
+    GzipReader(const GzipReader &);
+    GzipReader &operator=(const GzipReader &);
+
+public:
+    GzipReader(const std::string &filename, size_t chunkSize = 1 << 20, size_t depth = 4);
+    ~GzipReader();
+
+    bool isOpen() const { return opened; }
+
+    // Obtener el siguiente bloque descomprimido. El bloque sigue siendo valido
+    // hasta la siguiente llamada. Retorna false al final del archivo.
+    bool next(const char *&data, size_t &length);
+
+    // Verdadero si la descompresion termino con error (archivo truncado, etc.)
+    bool hasError();
+
+    // Verdadero si el archivo comienza con la firma gzip (1f 8b)
+    static bool isGzipFile(const std::string &filename);
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef HASHPOLICY_H
+#define HASHPOLICY_H
+
+#include <cstddef>
+#include <cstdint>
+#include "City.h"
+#include "MurmurHash2.h"
+#include "MurmurHash3.h"
+#include "Spooky.h"
+#include "kmer128.h"
+#include "kmerhash.h"
+
+// Definida en lookup3.cpp, que no tiene cabecera propia
+uint32_t lookup3(const void *key, int length, uint32_t initval);
+
+// Politicas de hash para BasicHyperLogLog. Cada politica es una clase con
+// funciones estaticas en linea, de modo que la llamada se resuelve al compilar
+// y no pasa por un puntero como pfHash en SMHasher. Los adaptadores de las
+// funciones de SMHasher se expanden en el llamador, pero el cuerpo del hash
+// sigue en su .cpp; solo kmerHash64 queda completo en linea.
+//
+//   static uint32_t hash(const char *data, size_t length);  // bytes arbitrarios
+//   static uint32_t hashKmer(uint64_t code);                // k-mer <= 32 bases
+//   static uint32_t hashKmer(const Kmer128 &kmer);          // k-mer <= 64 bases
+//   static const char *name();                              // nombre guardado en las bases
+//
+// Todas usan semilla 0 y entregan 32 bits (los altos si el hash es de 64).
+
+// Base para las politicas que hashean los k-mers como sus bytes en memoria
+template <typename Derived>
+struct BytesHashPolicy {
+    static uint32_t hashKmer(uint64_t code) {
+        return Derived::hash(reinterpret_cast<const char *>(&code), sizeof(code));
+    }
+    static uint32_t hashKmer(const Kmer128 &kmer) {
+        return Derived::hash(reinterpret_cast<const char *>(&kmer), sizeof(kmer));
+    }
+};
+
+// Bob Jenkins' SpookyHash, 32 bits
+struct SpookyHashPolicy : BytesHashPolicy<SpookyHashPolicy> {
+    static uint32_t hash(const char *data, size_t length) { return SpookyHash::Hash32(data, length, 0); }
+    static const char *name() { return "Spooky32"; }
+};
+
+// Google CityHash64
+struct CityHashPolicy : BytesHashPolicy<CityHashPolicy> {
+    static uint32_t hash(const char *data, size_t length) {
+        return static_cast<uint32_t>(CityHash64(data, length) >> 32);
+    }
+    static const char *name() { return "City64"; }
+};
+
+// MurmurHash3 para x86, 32 bits
+struct Murmur3HashPolicy : BytesHashPolicy<Murmur3HashPolicy> {
+    static uint32_t hash(const char *data, size_t length) {
+        uint32_t out;
+        MurmurHash3_x86_32(data, static_cast<int>(length), 0, &out);
+        return out;
+    }
+    static const char *name() { return "Murmur3A"; }
+};
+
+// MurmurHash2 para x64, 64 bits
+struct Murmur2HashPolicy : BytesHashPolicy<Murmur2HashPolicy> {
+    static uint32_t hash(const char *data, size_t length) {
+        return static_cast<uint32_t>(MurmurHash64A(data, static_cast<int>(length), 0) >> 32);
+    }
+    static const char *name() { return "Murmur2B"; }
+};
+
+// Bob Jenkins' lookup3
+struct Lookup3HashPolicy : BytesHashPolicy<Lookup3HashPolicy> {
+    static uint32_t hash(const char *data, size_t length) { return lookup3(data, static_cast<int>(length), 0); }
+    static const char *name() { return "lookup3"; }
+};
+
+// Politica por defecto: SpookyHash para bytes y kmerHash64 (en linea) para
+// los k-mers ya codificados
+struct DefaultHashPolicy {
+    static uint32_t hash(const char *data, size_t length) { return SpookyHashPolicy::hash(data, length); }
+    static uint32_t hashKmer(uint64_t code) { return static_cast<uint32_t>(kmerHash64(code) >> 32); }
+    static uint32_t hashKmer(const Kmer128 &kmer) { return static_cast<uint32_t>(hashKmer128(kmer) >> 32); }
+    static const char *name() { return "Spooky32+KmerHash64"; }
+};
+
+#endif
@@ -4,53 +4,60 @@
 #include <cstdint>
 #include <climits>
 #include <algorithm> 
+#include <istream>
+#include <ostream>
 #include "hyperloglog.h"
-#include "Spooky.h" 
 
 // Constructor inicializando los registros con ceros
-HyperLogLog::HyperLogLog() : registers(m, 0) {}
+template <typename HashPolicy>
+BasicHyperLogLog<HashPolicy>::BasicHyperLogLog() : registers(m, 0) {}
 
-// Usamos __buildtin_clz__ para contar los ceros a la izquierda
-int HyperLogLog::countLeadingZeros(uint32_t hashValue) {
-    return __builtin_clz(hashValue);
-}
-
-// Función hash utilizando SpookyHash
-uint32_t HyperLogLog::hash(const std::string &data) {
-    // Usar SpookyHash32 para calcular el hash
-    return SpookyHash::Hash32(data.c_str(), data.size(), 0);
-}
-
-// Añadir un elemento al HyperLogLog
-void HyperLogLog::add(const std::string &data) {
-    uint32_t hashValue = hash(data);
+// 2^-r para cada valor posible de un registro
+static const struct InversePowers {
+    double values[33];
+    InversePowers() {
+        for (int r = 0; r <= 32; ++r) values[r] = 1.0 / (uint64_t(1) << r);
+    }
+} inversePowers;
 
-    // Extraer el índice del registro (los primeros p bits del hash)
-    int registerIndex = hashValue >> (32 - p);
+// Estimar la cardinalidad usando HyperLogLog
+template <typename HashPolicy>
+double BasicHyperLogLog<HashPolicy>::estimate() const {
+    double harmonicSum = 0.0;
+    int zeroCount = 0;
 
-    // Contar los ceros en el resto de los bits sin desplazamiento
-    int leadingZeros = countLeadingZeros(hashValue << p);  // Usa los bits restantes sin perder información
+    for (int reg : registers) {
+        harmonicSum += inversePowers.values[reg];
+        zeroCount += reg == 0;
+    }
 
-    // Actualizamos el registro con el máximo número de ceros encontrados
-    registers[registerIndex] = std::max(registers[registerIndex], leadingZeros);
+    return correctedEstimate(harmonicSum, zeroCount);
 }
 
-
-// Estimar la cardinalidad usando HyperLogLog
-double HyperLogLog::estimate() {
-    // Estimador para la cardinalidad
-    double alphaMM = 0.7213 / (1 + 1.079 / m) * m * m;
+// Igual que copiar, fusionar y estimar, pero recorriendo ambos registros a la
+// vez sin reservar memoria
+template <typename HashPolicy>
+double BasicHyperLogLog<HashPolicy>::estimateUnion(const BasicHyperLogLog &other) const {
     double harmonicSum = 0.0;
+    int zeroCount = 0;
 
-    for (int reg : registers) {
-        harmonicSum += 1.0 / (1 << reg);
+    for (size_t i = 0; i < registers.size(); ++i) {
+        uint8_t reg = std::max(registers[i], other.registers[i]);
+        harmonicSum += inversePowers.values[reg];
+        zeroCount += reg == 0;
     }
 
+    return correctedEstimate(harmonicSum, zeroCount);
+}
+
+template <typename HashPolicy>
+double BasicHyperLogLog<HashPolicy>::correctedEstimate(double harmonicSum, int zeroCount) {
+    // Estimador para la cardinalidad
+    double alphaMM = 0.7213 / (1 + 1.079 / m) * m * m;
     double rawEstimate = alphaMM / harmonicSum;
 
     // Aplicar correcciones
     if (rawEstimate <= (5.0 / 2.0) * m) {
-        int zeroCount = std::count(registers.begin(), registers.end(), 0);
         if (zeroCount > 0) {
             return m * std::log(static_cast<double>(m) / zeroCount);
         }
@@ -65,8 +72,36 @@ double HyperLogLog::estimate() {
 }
 
 // Función para fusionar dos HyperLogLog
-void HyperLogLog::merge(const HyperLogLog &other) {
+template <typename HashPolicy>
+void BasicHyperLogLog<HashPolicy>::merge(const BasicHyperLogLog &other) {
     for (size_t i = 0; i < registers.size(); ++i) {
         registers[i] = std::max(registers[i], other.registers[i]);
     }
 }
+
+// Los registros se escriben tal cual, m bytes
+template <typename HashPolicy>
+bool BasicHyperLogLog<HashPolicy>::write(std::ostream &out) const {
+    out.write(reinterpret_cast<const char *>(registers.data()), registers.size());
+    return static_cast<bool>(out);
+}
+
+// Un registro mayor que 32 no lo pudo escribir addHash y se saldria de
+// inversePowers en estimate()
+template <typename HashPolicy>
+bool BasicHyperLogLog<HashPolicy>::read(std::istream &in) {
+    in.read(reinterpret_cast<char *>(registers.data()), registers.size());
+    if (!in) return false;
+    for (uint8_t reg : registers) {
+        if (reg > 32) return false;
+    }
+    return true;
+}
+
+// Una instancia por cada politica de hashpolicy.h
+template class BasicHyperLogLog<DefaultHashPolicy>;
+template class BasicHyperLogLog<SpookyHashPolicy>;
+template class BasicHyperLogLog<CityHashPolicy>;
+template class BasicHyperLogLog<Murmur3HashPolicy>;
+template class BasicHyperLogLog<Murmur2HashPolicy>;
+template class BasicHyperLogLog<Lookup3HashPolicy>;
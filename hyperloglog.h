@@ -1,32 +1,91 @@
 #ifndef HYPERLOGLOG_H
 #define HYPERLOGLOG_H
 
+#include <algorithm>
+#include <cstdint>
+#include <iosfwd>
 #include <vector>
 #include <string>
+#include "hashpolicy.h"
 
-class HyperLogLog {
+// HyperLogLog parametrizado por la politica de hash (ver hashpolicy.h). Las
+// funciones que se llaman por cada k-mer estan aqui para que el hash de la
+// politica quede en linea; el resto esta en hyperloglog.cpp, instanciado para
+// cada politica. Sketches hechos con politicas distintas no son comparables.
+template <typename HashPolicy>
+class BasicHyperLogLog {
 private:
-    std::vector<int> registers;
-    static const int p = 18; // 2^14 buckets
+    std::vector<uint8_t> registers;  // Un byte por registro (valores <= 32)
+    static const int p = 18; // 2^18 buckets
     static const int m = 1 << p;
 
+    // Estimacion con las correcciones de rango pequeño y grande
+    static double correctedEstimate(double harmonicSum, int zeroCount);
+
 public:
-    HyperLogLog();  // Constructor
+    typedef HashPolicy Policy;
+
+    BasicHyperLogLog();  // Constructor
 
     // Añadir un elemento al HyperLogLog
-    void add(const std::string &data);
+    void add(const std::string &data) { add(data.c_str(), data.size()); }
+
+    // Añadir un elemento dado como puntero y largo (k-mer sin copiar)
+    void add(const char *data, size_t length) { addHash(hash(data, length)); }
+
+    // Añadir un elemento cuyo hash ya fue calculado con hash()
+    void addHash(uint32_t hashValue) {
+        // Extraer el índice del registro (los primeros p bits del hash)
+        int registerIndex = hashValue >> (32 - p);
+
+        // Contar los ceros en los 32 - p bits restantes. __builtin_clz(0) no
+        // esta definido, asi que se marca el bit siguiente a ellos: el conteo
+        // queda acotado por 32 - p y no se sale de la tabla de estimate()
+        int leadingZeros = countLeadingZeros((hashValue << p) | (1u << (p - 1)));
+
+        // Actualizamos el registro con el máximo número de ceros encontrados
+        registers[registerIndex] = std::max<uint8_t>(registers[registerIndex], leadingZeros);
+    }
+
+    // Añadir un k-mer codificado a 2 bits por base
+    void addKmer(uint64_t code) { addHash(hashKmer(code)); }
+
+    // Añadir un k-mer de hasta 64 bases (dos palabras)
+    void addKmer(const Kmer128 &kmer) { addHash(hashKmer(kmer)); }
 
     // Estimar la cardinalidad
-    double estimate();
+    double estimate() const;
 
-    // Función hash utilizando SpookyHash
-    static uint32_t hash(const std::string &data);
+    // Estimar la cardinalidad de la union con `other` sin construirla
+    double estimateUnion(const BasicHyperLogLog &other) const;
 
-    // Contar ceros a la izquierda
-    static int countLeadingZeros(uint32_t hashValue);
+    // Funciones hash de la politica
+    static uint32_t hash(const std::string &data) { return hash(data.c_str(), data.size()); }
+    static uint32_t hash(const char *data, size_t length) { return HashPolicy::hash(data, length); }
+    static uint32_t hashKmer(uint64_t code) { return HashPolicy::hashKmer(code); }
+    static uint32_t hashKmer(const Kmer128 &kmer) { return HashPolicy::hashKmer(kmer); }
+
+    // Contar ceros a la izquierda (usamos __builtin_clz)
+    static int countLeadingZeros(uint32_t hashValue) { return __builtin_clz(hashValue); }
 
     // Método para fusionar dos HyperLogLog
-    void merge(const HyperLogLog &other);
+    void merge(const BasicHyperLogLog &other);
+
+    // Guardar y cargar los registros en formato binario
+    bool write(std::ostream &out) const;
+    bool read(std::istream &in);
+
+    // Registros en memoria (2^p bytes), p.ej. para indexarlos
+    const uint8_t *registerData() const { return registers.data(); }
+
+    static int precision() { return p; }
 };
 
+// Politica elegida al compilar, p.ej. -DHLL_HASH_POLICY=CityHashPolicy
+#ifndef HLL_HASH_POLICY
+#define HLL_HASH_POLICY DefaultHashPolicy
+#endif
+
+typedef BasicHyperLogLog<HLL_HASH_POLICY> HyperLogLog;
+
 #endif
@@ -0,0 +1,50 @@
+#ifndef INTERSECTION_H
+#define INTERSECTION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Ordenar y quitar los repetidos de una lista de k-mers
+template <typename T>
+void sortUnique(std::vector<T> &values) {
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+}
+
+// Tamaño de la interseccion de dos arreglos ordenados y sin repetir, sin
+// construir la interseccion ni la union (|A u B| = |A| + |B| - |A n B|) y sin
+// pedir memoria. Con tamaños parecidos se mezclan ambos arreglos avanzando
+// sin saltos condicionales; si uno es mucho mas chico cada elemento suyo se
+// busca en el grande con busqueda exponencial desde la posicion anterior.
+template <typename T>
+size_t intersectionSize(const std::vector<T> &a, const std::vector<T> &b) {
+    const std::vector<T> &small = a.size() <= b.size() ? a : b;
+    const std::vector<T> &large = a.size() <= b.size() ? b : a;
+    size_t shared = 0;
+
+    if (small.size() * 32 < large.size()) {
+        size_t from = 0;
+        for (const T &value : small) {
+            size_t step = 1;
+            while (from + step < large.size() && large[from + step] < value) step <<= 1;
+            size_t to = std::min(from + step + 1, large.size());
+            from = std::lower_bound(large.begin() + from, large.begin() + to, value) - large.begin();
+            if (from == large.size()) break;
+            shared += large[from] == value;
+        }
+        return shared;
+    }
+
+    size_t i = 0, j = 0;
+    while (i < small.size() && j < large.size()) {
+        const T &x = small[i];
+        const T &y = large[j];
+        shared += x == y;
+        i += !(y < x);
+        j += !(x < y);
+    }
+    return shared;
+}
+
+#endif
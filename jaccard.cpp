@@ -1,81 +1,186 @@
 #include <iostream>
 #include <fstream>
-#include <unordered_set>
+#include <algorithm>
 #include <vector>
 #include <cmath>  
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "abundance.h"
+#include "fracminhash.h"
 #include "hyperloglog.h"
+#include "intersection.h"
+#include "kmer.h"
+#include "kmer128.h"
+#include "kmerindex.h"
+#include "minhash.h"
+#include "bbitminhash.h"
+#include "lshindex.h"
+#include "packedseq.h"
+#include "pipeline.h"
+#include "search.h"
+#include "seqreader.h"
+#include "sketchdb.h"
+#include "sketcher.h"
+#include "threadpool.h"
+#include "vptree.h"
 
-// Función para generar k-mers de una secuencia
-std::unordered_set<std::string> generateKMers(const std::string& sequence, int k) {
-    std::unordered_set<std::string> kmers;
-    for (size_t i = 0; i <= sequence.size() - k; ++i) {
-        kmers.insert(sequence.substr(i, k));
+// Genoma (o muestra de lecturas) empaquetado a 2 bits por base, con sus
+// k-mers codificados (ordenados y sin repetir) y su HyperLogLog. Con k > 32
+// los k-mers van en `wideKmers` en vez de `kmers`. Con muestreo los k-mers elegidos quedan
+// ademas en `sampledKmers` y en su indice, para estimar la contencion.
+struct GenomeSketch {
+    std::string name;
+    PackedSequence sequence;
+    std::vector<uint64_t> kmers;
+    std::vector<Kmer128> wideKmers;
+    HyperLogLog hll;
+    std::vector<uint64_t> sampledKmers;
+    KmerIndex sampledIndex;
+    FracMinHash fracMinHash;
+    MinHash minHash;
+};
+
+// Recibe los registros de readSequenceFile y guarda cada genoma empaquetado,
+// usando la cuarta parte de la memoria que el texto ASCII.
+// En modo lecturas (pooled) todas las lecturas de un archivo forman una sola
+// muestra, delimitada por beginFile()/endFile().
+class GenomeCollector {
+private:
+    std::vector<GenomeSketch> &genomes;
+    size_t maxGenomes;
+    GenomeSketch current;
+    bool pooled;
+
+    void startSample(const std::string &name) {
+        current = GenomeSketch();
+        current.name = name;
     }
-    return kmers;
-}
 
-// Función para calcular la similitud de Jaccard real
-double realJaccard(const std::unordered_set<std::string>& kmersA, const std::unordered_set<std::string>& kmersB) {
-    int intersectionSize = 0;
-    for (const auto& kmer : kmersA) {
-        if (kmersB.find(kmer) != kmersB.end()) {
-            intersectionSize++;
+    bool finishSample() {
+        if (current.sequence.size() > 0) {  // Saltar registros sin secuencia
+            genomes.push_back(std::move(current));
         }
+        return genomes.size() < maxGenomes;
     }
-    int unionSize = kmersA.size() + kmersB.size() - intersectionSize;
-    return static_cast<double>(intersectionSize) / unionSize;
-}
 
-// Función para calcular la similitud de Jaccard estimada usando HyperLogLog
-double jaccardSimilarity(HyperLogLog& hllA, HyperLogLog& hllB) {
-    double estimateA = hllA.estimate();
-    double estimateB = hllB.estimate();
+public:
+    GenomeCollector(std::vector<GenomeSketch> &genomes, size_t maxGenomes, bool pooled = false)
+        : genomes(genomes), maxGenomes(maxGenomes), pooled(pooled) {}
 
-    // Fusionar ambos HyperLogLog para estimar la unión
-    HyperLogLog hllUnion = hllA;
-    hllUnion.merge(hllB);
-    double estimateUnion = hllUnion.estimate();
+    void beginFile(const std::string &filename) {
+        if (pooled) startSample(filename);
+    }
 
-    // Calcular la similitud de Jaccard asegurando que no sea negativa
-    double jaccard = std::max(0.0, (estimateA + estimateB - estimateUnion) / estimateUnion);
+    bool endFile() {
+        return pooled ? finishSample() : genomes.size() < maxGenomes;
+    }
 
-    return jaccard;
-}
+    void beginRecord(const std::string &header) {
+        if (pooled) {
+            current.sequence.startRecord();  // Los k-mers no cruzan de una lectura a otra
+        } else {
+            startSample(header);
+        }
+    }
 
-// Funcion para leer el archivo de genomas
-std::vector<std::string> readGenomesFromFile(const std::string& filename, int numGenomes) {
-    std::ifstream infile(filename);
-    std::string line;
-    std::vector<std::string> genomes;
-    std::string currentGenome;
-    int genomeCount = 0;
+    void sequence(const char *data, size_t length) {
+        current.sequence.append(data, length);
+    }
 
-    while (std::getline(infile, line)) {
-        if (line.empty()) continue;  // Saltar líneas vacías
+    bool endRecord() {
+        return pooled ? true : finishSample();
+    }
+};
 
-        // Si encontramos un nuevo genoma (línea que empieza con '>')
-        if (line[0] == '>') {
-            if (!currentGenome.empty()) {
-                genomes.push_back(currentGenome);
-                currentGenome.clear();
-                genomeCount++;
-            }
+// Agregar un k-mer a la lista, ordenandola y quitando repetidos cada vez que
+// duplica su tamaño para no guardar cada aparicion (p.ej. la cobertura de
+// una muestra de lecturas)
+template <typename Kmer>
+static void appendKmer(std::vector<Kmer>& kmers, size_t& compactAt, const Kmer& kmer) {
+    kmers.push_back(kmer);
+    if (kmers.size() < compactAt) return;
+    sortUnique(kmers);
+    compactAt = 2 * kmers.size() + (1 << 20);
+}
 
-            if (genomeCount >= numGenomes) {
-                break;  // Solo procesamos el número de genomas solicitado
-            }
-        } else {
-            // Concatenar las líneas que contienen la secuencia de ADN
-            currentGenome += line;
-        }
+// Generar los k-mers de un genoma empaquetado (sin los que tienen bases
+// ambiguas) y llenar su HyperLogLog. El filtro de abundancia y el muestreo
+// solo se usan con k <= 32; con muestreo el conjunto de k-mers sigue completo
+// (para el Jaccard real) pero al HyperLogLog solo entran los elegidos. Con
+// `scaled` > 0 tambien se llena un FracMinHash con todos los k-mers, y con
+// `minHashBits` > 0 un MinHash de 2^minHashBits bins.
+void buildKmers(GenomeSketch& genome, int k, AbundanceFilter* filter, bool canonical,
+                const KmerSampling& sampling, uint64_t scaled, int minHashBits) {
+    if (scaled > 0) genome.fracMinHash = FracMinHash(scaled);
+    if (minHashBits > 0) genome.minHash = MinHash(minHashBits);
+    if (k > 32) {
+        size_t compactAt = 1 << 20;
+        genome.sequence.forEachKmer128(k, [&genome, &compactAt, scaled, minHashBits](const Kmer128& kmer, uint64_t) {
+            appendKmer(genome.wideKmers, compactAt, kmer);
+            genome.hll.addKmer(kmer);
+            if (scaled > 0) genome.fracMinHash.addKmer(kmer);
+            if (minHashBits > 0) genome.minHash.addKmer(kmer);
+        }, canonical);
+        sortUnique(genome.wideKmers);
+        genome.fracMinHash.finish();
+        genome.minHash.finish();
+        return;
     }
+    if (filter) filter->clear();
+    bool sampled = sampling.mode != KmerSampling::AllKmers;
+    size_t compactAt = 1 << 20;
+    genome.sequence.forEachKmer(k, [&genome, &compactAt, filter, sampled, scaled, minHashBits](uint64_t code, uint64_t) {
+        if (filter && !filter->add(code)) return;
+        appendKmer(genome.kmers, compactAt, code);
+        if (!sampled) genome.hll.addKmer(code);
+        if (scaled > 0) genome.fracMinHash.addKmer(code);
+        if (minHashBits > 0) genome.minHash.addKmer(code);
+    }, canonical);
+    sortUnique(genome.kmers);
+    genome.fracMinHash.finish();
+    genome.minHash.finish();
 
-    // Agregar el último genoma si es necesario
-    if (!currentGenome.empty() && genomeCount < numGenomes) {
-        genomes.push_back(currentGenome);
+    auto addSampled = [&genome](const Minimizer& kmer) {
+        genome.hll.addKmer(kmer.kmer);
+        if (genome.sampledIndex.insert(kmer.kmer)) genome.sampledKmers.push_back(kmer.kmer);
+    };
+    if (sampling.mode == KmerSampling::Minimizers) {
+        MinimizerFinder finder(k, sampling.parameter, canonical);
+        genome.sequence.forEachSampledKmer(finder, addSampled);
+    } else if (sampling.mode == KmerSampling::Syncmers) {
+        SyncmerFinder finder(k, sampling.parameter, ClosedSyncmer, 0, canonical);
+        genome.sequence.forEachSampledKmer(finder, addSampled);
     }
+}
 
-    return genomes;
+// Función para calcular la similitud de Jaccard real, sobre los k-mers
+// ordenados: solo se cuenta la interseccion y la union sale de los tamaños
+template <typename Kmer>
+double realJaccard(const std::vector<Kmer>& kmersA, const std::vector<Kmer>& kmersB) {
+    size_t shared = intersectionSize(kmersA, kmersB);
+    size_t unionSize = kmersA.size() + kmersB.size() - shared;
+    return static_cast<double>(shared) / unionSize;
+}
+
+// Contencion real de A en B: fraccion de los k-mers de A que estan en B
+template <typename Kmer>
+double realContainment(const std::vector<Kmer>& kmersA, const std::vector<Kmer>& kmersB) {
+    return kmersA.empty() ? 0.0 : static_cast<double>(intersectionSize(kmersA, kmersB)) / kmersA.size();
+}
+
+// Función para calcular la similitud de Jaccard estimada usando HyperLogLog
+double jaccardSimilarity(const HyperLogLog& hllA, const HyperLogLog& hllB) {
+    double estimateA = hllA.estimate();
+    double estimateB = hllB.estimate();
+
+    // Estimar la unión sin construir el HyperLogLog fusionado
+    double estimateUnion = hllA.estimateUnion(hllB);
+
+    return jaccardFromEstimates(estimateA, estimateB, estimateUnion);
 }
 
 // Función para calcular ERM y EAM para una comparación específica
@@ -95,13 +200,558 @@ void CalculodeErrores(double realJaccard, double estimatedJaccard) {
     std::cout << "Error Absoluto Medio (EAM): " << eam << std::endl;
 }
 
-int main() {
-    std::string filename = "GCF_001969825.1_ASM196982v1_genomic.fna";
+void printUsage(const char* program) {
+    std::cerr << "Uso: " << program << " [-n numGenomas] [-k k] [-a minAbundancia [-e millones]] [-r] [-C] [-w w | -s s] [-f scaled] [-m bits [-b b]] [archivo ...]" << std::endl
+              << "  Compara los genomas (k <= 64) guardandolos empaquetados a 2 bits por base." << std::endl
+              << "  Cada registro FASTA es un genoma; con -r cada archivo (p.ej. lecturas FASTQ)" << std::endl
+              << "  es una muestra. Con -a solo se cuentan los k-mers vistos al menos esa cantidad" << std::endl
+              << "  de veces (solo con k <= 32); -e es la cantidad esperada de k-mers distintos por" << std::endl
+              << "  muestra en millones, con errores (por defecto 32), y fija la memoria del filtro." << std::endl
+              << "  Con -C cada k-mer se cuenta en su forma canonica" << std::endl
+              << "  (el menor entre el y su reverso complementario). Se aceptan archivos" << std::endl
+              << "  FASTA/FASTQ, planos o comprimidos con gzip." << std::endl
+              << "  Con -w solo entran al HyperLogLog los minimizadores de ventanas de w bases y" << std::endl
+              << "  con -s los syncmers cerrados de s-mers de largo s (k <= 32, sin -a); se muestra" << std::endl
+              << "  el Jaccard del espacio muestreado y el corregido a k-mers." << std::endl
+              << "  Con -f se muestran ademas el Jaccard y la contencion de sketches FracMinHash" << std::endl
+              << "  que guardan 1 de cada `scaled` k-mers (elegidos por su hash), y con -m el" << std::endl
+              << "  Jaccard de un MinHash de una permutacion con 2^bits bins (4 a 24); con -b" << std::endl
+              << "  tambien el de su version de b bits por bin (1 a 32)." << std::endl
+              << std::endl
+              << "     " << program << " sketch [-k k[,k...]] [-t hilos] [-a minAbundancia [-e millones]] [-c megabases] [-p] [-C] [-w w | -s s] [-l lista] [-o salida] [archivo ...]" << std::endl
+              << "  Construye en paralelo un sketch por archivo (los archivos de -l van uno por" << std::endl
+              << "  linea) y los guarda en `salida` (por defecto sketches.hll). Los FASTA sin" << std::endl
+              << "  comprimir se dividen en trozos de -c megabases (por defecto 4) que se procesan en paralelo." << std::endl
+              << "  Con -p los archivos pasan en orden por un pipeline lectura -> hash -> sketch" << std::endl
+              << "  de tres hilos con memoria acotada (no admite -a)." << std::endl
+              << "  Con -a cada hilo usa un filtro dimensionado por el archivo que procesa, de a" << std::endl
+              << "  lo mas 12 a 24 bytes por k-mer de -e (384 MB con -e 32): la memoria total es" << std::endl
+              << "  a lo mas hilos x eso, y si supera la memoria del equipo se rechaza." << std::endl
+              << "  Con varios k (p.ej. -k 16,21,31) todos se calculan en una sola pasada y se" << std::endl
+              << "  escribe un archivo salida.k<k> por cada uno (no admite -a ni -p)." << std::endl
+              << "  Se admite k <= 64; un k mayor que 32 va solo y no admite -a." << std::endl
+              << "  Con -w o -s se muestrean los k-mers como en la comparacion (un solo k <= 32," << std::endl
+              << "  sin -a ni -p)." << std::endl
+              << std::endl
+              << "     " << program << " query -d base [-n mejores] [-t hilos] [-j umbral | -v] [-C] [-w w | -s s] [archivo ...]" << std::endl
+              << "  Construye el sketch de cada archivo de consulta con el k de la base (creada" << std::endl
+              << "  con sketch) y muestra sus -n (por defecto 10) referencias mas parecidas." << std::endl
+              << "  La base se recorre en paralelo; -C, -w y -s deben coincidir con los usados en" << std::endl
+              << "  sketch (con -w o -s se informa el Jaccard del espacio muestreado)." << std::endl
+              << "  Con -j solo se comparan los candidatos del indice base.lsh (creado con index)" << std::endl
+              << "  y se muestran los que tienen Jaccard estimado >= umbral. Con -v se buscan los" << std::endl
+              << "  vecinos en el arbol base.vpt, comparando solo las ramas que no se pueden" << std::endl
+              << "  descartar por la desigualdad triangular." << std::endl
+              << std::endl
+              << "     " << program << " index [-b bandas] [-r filas] [-v] [-t hilos] base" << std::endl
+              << "  Crea base.lsh, un indice LSH con -b (por defecto 64) bandas de -r (por" << std::endl
+              << "  defecto 8) registros de HyperLogLog cada una. Mas filas suben el umbral de" << std::endl
+              << "  Jaccard a partir del cual dos sketches quedan como candidatos. Con -v crea en" << std::endl
+              << "  cambio base.vpt, un arbol de puntos de vista con la distancia 1 - Jaccard." << std::endl;
+}
+
+// Tamaño del archivo en bytes, 0 si no existe
+static size_t fileSize(const std::string& filename) {
+    struct stat st;
+    return stat(filename.c_str(), &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+}
+
+// Lista de valores de k separados por coma, p.ej. "16,21,31"
+static std::vector<int> parseKList(const std::string& text) {
+    std::vector<int> ks;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == std::string::npos) comma = text.size();
+        ks.push_back(std::atoi(text.substr(start, comma - start).c_str()));
+        start = comma + 1;
+    }
+    return ks;
+}
+
+// Cantidad en millones, p.ej. "32" o "2.5"; 0 si no es valida
+static uint64_t parseMillions(const char* text) {
+    double millions = std::atof(text);
+    return millions > 0.0 && millions < 1e9 ? static_cast<uint64_t>(millions * 1e6) : 0;
+}
+
+// -e fija la memoria del filtro de abundancia, asi que se acota antes de
+// reservarla
+static bool validExpectedKmers(uint64_t expectedKmers) {
+    if (expectedKmers >= 1 && expectedKmers <= AbundanceFilter::maxExpectedKmers) return true;
+    std::cerr << "-e debe ser mayor que 0 y a lo mas " << AbundanceFilter::maxExpectedKmers / 1000000
+              << " millones de k-mers (" << (AbundanceFilter::memoryFor(AbundanceFilter::maxExpectedKmers) >> 30)
+              << " GB de contadores)" << std::endl;
+    return false;
+}
+
+// Opcion de muestreo en palabras, para los mensajes de error
+static std::string samplingDescription(const KmerSampling& sampling) {
+    if (sampling.mode == KmerSampling::Minimizers) return "con -w " + std::to_string(sampling.parameter);
+    if (sampling.mode == KmerSampling::Syncmers) return "con -s " + std::to_string(sampling.parameter);
+    return "sin -w ni -s";
+}
+
+// El muestreo necesita k <= 32, ventanas de al menos un k-mer y s-mers de 1 a
+// k bases
+static bool validSampling(const KmerSampling& sampling, int k) {
+    switch (sampling.mode) {
+        case KmerSampling::Minimizers: return k <= 32 && sampling.parameter >= k;
+        case KmerSampling::Syncmers: return k <= 32 && sampling.parameter >= 1 && sampling.parameter <= k;
+        default: return true;
+    }
+}
+
+// Filtros de abundancia del comando sketch. Cada tarea toma uno libre y lo
+// devuelve al terminar, asi que hay a lo mas uno por hilo y no se reserva uno
+// por archivo. Cada filtro se dimensiona por su archivo, con -e como tope: uno
+// sin comprimir de n bytes tiene a lo mas n k-mers distintos, y en un .gz de n
+// bytes la secuencia ocupa a lo mas ~4n bytes (2 bits por base), asi que se
+// usan 8n como cota con margen.
+class AbundanceFilterPool {
+private:
+    std::mutex mutex;
+    std::vector<std::unique_ptr<AbundanceFilter> > available;
+    uint32_t minCount;
+    uint64_t expectedKmers;
+
+public:
+    AbundanceFilterPool(uint32_t minCount, uint64_t expectedKmers) : minCount(minCount), expectedKmers(expectedKmers) {}
+
+    // K-mers distintos para los que se dimensiona el filtro del archivo
+    uint64_t expectedFor(const std::string& filename) const {
+        uint64_t bound = fileSize(filename);
+        if (GzipReader::isGzipFile(filename)) bound = bound > UINT64_MAX / 8 ? UINT64_MAX : 8 * bound;
+        return std::min(expectedKmers, bound);
+    }
+
+    // Un filtro vacio dimensionado para el archivo
+    std::unique_ptr<AbundanceFilter> acquire(const std::string& filename) {
+        uint64_t expected = expectedFor(filename);
+        size_t memory = AbundanceFilter::memoryFor(expected);
+
+        std::unique_ptr<AbundanceFilter> filter;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!available.empty()) {
+                filter = std::move(available.back());
+                available.pop_back();
+            }
+        }
+        if (filter && filter->memory() == memory) {
+            filter->clear();
+        } else {
+            filter.reset(new AbundanceFilter(minCount, expected));
+        }
+        return filter;
+    }
+
+    void release(std::unique_ptr<AbundanceFilter> filter) {
+        std::lock_guard<std::mutex> lock(mutex);
+        available.push_back(std::move(filter));
+    }
+};
+
+// Comando sketch: un HyperLogLog por archivo, construidos en un pool con robo
+// de trabajo y guardados en una SketchDatabase
+int runSketch(int argc, char* argv[], const char* program) {
+    std::vector<std::string> filenames;
+    std::string output = "sketches.hll";
+    std::vector<int> ks;
+    int threads = 0;  // 0 = un hilo por nucleo
+    int minAbundance = 1;
+    uint64_t expectedKmers = AbundanceFilter::defaultExpectedKmers;
+    long chunkMegabases = 4;  // Registros mas largos se dividen en trozos paralelos
+    bool pipelined = false;
+    bool canonical = false;
+    KmerSampling sampling;
+
+    int option;
+    while ((option = getopt(argc, argv, "k:t:a:e:c:pCw:s:l:o:")) != -1) {
+        switch (option) {
+            case 'p': pipelined = true; break;
+            case 'C': canonical = true; break;
+            case 'w': sampling = KmerSampling(KmerSampling::Minimizers, std::atoi(optarg)); break;
+            case 's': sampling = KmerSampling(KmerSampling::Syncmers, std::atoi(optarg)); break;
+            case 'k': ks = parseKList(optarg); break;
+            case 'c': chunkMegabases = std::atol(optarg); break;
+            case 't': threads = std::atoi(optarg); break;
+            case 'a': minAbundance = std::atoi(optarg); break;
+            case 'e': expectedKmers = parseMillions(optarg); break;
+            case 'o': output = optarg; break;
+            case 'l': {
+                std::ifstream list(optarg);
+                if (!list) {
+                    std::cerr << "No se pudo abrir la lista: " << optarg << std::endl;
+                    return 1;
+                }
+                std::string line;
+                while (std::getline(list, line)) {
+                    if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+                    if (!line.empty()) filenames.push_back(line);
+                }
+                break;
+            }
+            default: printUsage(program); return 1;
+        }
+    }
+    for (int i = optind; i < argc; ++i) {
+        filenames.push_back(argv[i]);
+    }
+    if (ks.empty()) ks.push_back(20);
+    // Los k-mers de mas de 32 bases ocupan dos palabras: solo de a un k y sin
+    // filtro de abundancia
+    bool validK = true;
+    for (int k : ks) validK = validK && k >= 1 && k <= 64 && (k <= 32 || (ks.size() == 1 && minAbundance == 1));
+    bool sampled = sampling.mode != KmerSampling::AllKmers;
+    if (!validExpectedKmers(expectedKmers)) return 1;
+    if (filenames.empty() || !validK || threads < 0 || minAbundance < 1 || chunkMegabases < 1 ||
+        (pipelined && minAbundance > 1) || (ks.size() > 1 && (pipelined || minAbundance > 1)) ||
+        (sampled && (ks.size() > 1 || pipelined || minAbundance > 1 || !validSampling(sampling, ks[0])))) {
+        printUsage(program);
+        return 1;
+    }
+
+    // Una coleccion de sketches por cada k
+    std::vector<SketchDatabase> databases(ks.size());
+    for (size_t j = 0; j < ks.size(); ++j) {
+        databases[j].k = ks[j];
+        databases[j].canonical = canonical;
+        databases[j].sampling = sampling;
+        databases[j].names = filenames;
+        databases[j].sketches.resize(filenames.size());
+    }
+    std::vector<char> ok(filenames.size(), 0);
+
+    // Encolar primero los archivos mas grandes para que los pequeños rellenen
+    // los huecos al final
+    std::vector<size_t> order(filenames.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::vector<size_t> sizes(filenames.size());
+    for (size_t i = 0; i < sizes.size(); ++i) sizes[i] = fileSize(filenames[i]);
+    std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+    // Hay a lo mas un filtro por hilo, asi que en el peor caso conviven tantos
+    // filtros como el mayor que se necesite
+    AbundanceFilterPool filters(minAbundance, expectedKmers);
+    if (minAbundance > 1) {
+        unsigned workers = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+        size_t largest = 0;
+        for (const auto& filename : filenames) {
+            largest = std::max(largest, AbundanceFilter::memoryFor(filters.expectedFor(filename)));
+        }
+        size_t concurrent = std::min<size_t>(workers, filenames.size());
+        uint64_t total = uint64_t(concurrent) * largest;
+        uint64_t physical = uint64_t(sysconf(_SC_PHYS_PAGES)) * uint64_t(sysconf(_SC_PAGE_SIZE));
+        if (total > physical) {
+            std::cerr << "Los filtros de -a necesitarian hasta " << (total >> 20) << " MB (" << concurrent
+                      << " hilos x " << (largest >> 20) << " MB) y hay " << (physical >> 20)
+                      << " MB de memoria: usar menos hilos (-t) o un -e menor" << std::endl;
+            return 1;
+        }
+    }
+
+    if (pipelined) {
+        sketchFilesPipelined(filenames, ks[0], databases[0].sketches, ok, canonical);
+    } else {
+        ThreadPool pool(threads);
+        for (size_t index : order) {
+            pool.submit([&, index] {
+                if (minAbundance > 1) {
+                    // El filtro cuenta sobre todo el archivo, no se puede dividir
+                    std::unique_ptr<AbundanceFilter> filter = filters.acquire(filenames[index]);
+                    ok[index] = sketchFile(filenames[index], ks[0], databases[0].sketches[index], filter.get(), canonical);
+                    filters.release(std::move(filter));
+                } else if (sampled) {
+                    ok[index] = sketchFile(filenames[index], ks[0], databases[0].sketches[index], sampling, canonical);
+                } else {
+                    std::vector<HyperLogLog*> sketches;
+                    for (auto& database : databases) sketches.push_back(&database.sketches[index]);
+                    ok[index] = sketchFileChunked(filenames[index], ks, sketches, pool, chunkMegabases * 1000000,
+                                                  canonical);
+                }
+            });
+        }
+        pool.wait();
+    }
+
+    // Los archivos que no se pudieron leer quedan fuera de la base: un sketch
+    // vacio apareceria despues como una referencia mas
+    size_t failures = 0;
+    size_t kept = 0;
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        if (!ok[i]) {
+            std::cerr << "No se pudo leer el archivo: " << filenames[i] << std::endl;
+            ++failures;
+            continue;
+        }
+        for (auto& database : databases) {
+            if (kept != i) {
+                database.names[kept].swap(database.names[i]);
+                std::swap(database.sketches[kept], database.sketches[i]);
+            }
+        }
+        ++kept;
+    }
+    for (auto& database : databases) {
+        database.names.resize(kept);
+        database.sketches.resize(kept);
+    }
+
+    // Con varios k se escribe un archivo por k: salida.k<k>
+    for (const auto& database : databases) {
+        std::string path = ks.size() > 1 ? output + ".k" + std::to_string(database.k) : output;
+        if (!database.save(path)) {
+            std::cerr << "No se pudo escribir " << path << std::endl;
+            return 1;
+        }
+        std::cerr << "Se guardaron " << kept << " sketches (k = " << database.k << ") en " << path << std::endl;
+    }
+    return failures > 0 ? 1 : 0;
+}
+
+// Comando query: las referencias mas parecidas a cada archivo de consulta
+int runQuery(int argc, char* argv[], const char* program) {
+    std::vector<std::string> filenames;
+    std::string databasePath;
+    long top = 10;
+    int threads = 0;
+    bool canonical = false;
+    double threshold = -1.0;  // < 0: recorrer toda la base
+    bool useTree = false;
+    KmerSampling sampling;
+
+    int option;
+    while ((option = getopt(argc, argv, "d:n:t:j:vCw:s:")) != -1) {
+        switch (option) {
+            case 'w': sampling = KmerSampling(KmerSampling::Minimizers, std::atoi(optarg)); break;
+            case 's': sampling = KmerSampling(KmerSampling::Syncmers, std::atoi(optarg)); break;
+            case 'v': useTree = true; break;
+            case 'd': databasePath = optarg; break;
+            case 'j': threshold = std::atof(optarg); break;
+            case 'n': top = std::atol(optarg); break;
+            case 't': threads = std::atoi(optarg); break;
+            case 'C': canonical = true; break;
+            default: printUsage(program); return 1;
+        }
+    }
+    for (int i = optind; i < argc; ++i) {
+        filenames.push_back(argv[i]);
+    }
+    if (databasePath.empty() || filenames.empty() || top < 1 || threads < 0 || threshold > 1.0 ||
+        (useTree && threshold >= 0.0)) {
+        printUsage(program);
+        return 1;
+    }
+
+    SketchDatabase database;
+    if (!database.load(databasePath)) {
+        std::cerr << "No se pudo leer la base de sketches (o es de otra precision o politica de hash): " << databasePath << std::endl;
+        return 1;
+    }
+    if (!validSampling(sampling, database.k)) {
+        printUsage(program);
+        return 1;
+    }
+    // Con y sin -C los k-mers de una hebra y de la otra cuentan distinto
+    if (canonical != database.canonical) {
+        std::cerr << "La base " << databasePath << (database.canonical ? " usa" : " no usa")
+                  << " k-mers canonicos: la consulta debe ir " << (database.canonical ? "con" : "sin") << " -C" << std::endl;
+        return 1;
+    }
+    // Un sketch muestreado y uno completo estiman Jaccard de conjuntos distintos
+    if (sampling.mode != database.sampling.mode || sampling.parameter != database.sampling.parameter) {
+        std::cerr << "La base " << databasePath << " se creo " << samplingDescription(database.sampling)
+                  << " y la consulta " << samplingDescription(sampling) << ": usar la misma opcion que en sketch" << std::endl;
+        return 1;
+    }
+    LshIndex index;
+    if (threshold >= 0.0) {
+        std::string indexPath = databasePath + ".lsh";
+        if (!index.load(indexPath, database.sketches.size())) {
+            std::cerr << "Falta el indice " << indexPath << " o no corresponde a la base (usar index)" << std::endl;
+            return 1;
+        }
+    }
+    VpTree tree;
+    if (useTree) {
+        std::string treePath = databasePath + ".vpt";
+        if (!tree.load(treePath, database.sketches.size())) {
+            std::cerr << "Falta el arbol " << treePath << " o no corresponde a la base (usar index -v)" << std::endl;
+            return 1;
+        }
+    }
+
+    // No hay mas resultados que referencias
+    top = std::min<long>(top, static_cast<long>(database.sketches.size()));
+
+    // Sketches de las consultas, con el mismo k que la base
+    ThreadPool pool(threads);
+    std::vector<HyperLogLog> queries(filenames.size());
+    std::vector<char> ok(filenames.size(), 0);
+    std::vector<int> ks(1, database.k);
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        pool.submit([&, i] {
+            if (sampling.mode != KmerSampling::AllKmers) {
+                ok[i] = sketchFile(filenames[i], database.k, queries[i], sampling, canonical);
+                return;
+            }
+            std::vector<HyperLogLog*> sketches(1, &queries[i]);
+            ok[i] = sketchFile(filenames[i], ks, sketches, canonical);
+        });
+    }
+    pool.wait();
+
+    SketchSearcher searcher(database, pool);
+    size_t failures = 0;
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        if (!ok[i]) {
+            std::cerr << "No se pudo leer el archivo: " << filenames[i] << std::endl;
+            ++failures;
+            continue;
+        }
+        std::vector<SearchHit> hits;
+        if (useTree) {
+            size_t comparisons;
+            hits = tree.nearest(searcher, queries[i], top, comparisons);
+            std::cerr << filenames[i] << ": " << comparisons << " de " << searcher.size() << " referencias comparadas" << std::endl;
+        } else if (threshold >= 0.0) {
+            hits = searcher.rank(queries[i], index.candidates(queries[i]), threshold, top);
+        } else {
+            hits = searcher.topK(queries[i], top, pool);
+        }
+        for (const auto& hit : hits) {
+            std::cout << filenames[i] << '\t' << database.names[hit.reference] << '\t' << hit.similarity << std::endl;
+        }
+    }
+    return failures > 0 ? 1 : 0;
+}
+
+// Comando index: indice LSH de una base de sketches, guardado junto a ella
+int runIndex(int argc, char* argv[], const char* program) {
+    int bands = 64;
+    int rows = 8;
+    bool useTree = false;
+    int threads = 0;
+
+    int option;
+    while ((option = getopt(argc, argv, "b:r:vt:")) != -1) {
+        switch (option) {
+            case 'v': useTree = true; break;
+            case 't': threads = std::atoi(optarg); break;
+            case 'b': bands = std::atoi(optarg); break;
+            case 'r': rows = std::atoi(optarg); break;
+            default: printUsage(program); return 1;
+        }
+    }
+    if (optind + 1 != argc || !LshIndex::validShape(bands, rows) || threads < 0) {
+        printUsage(program);
+        return 1;
+    }
+
+    std::string databasePath = argv[optind];
+    SketchDatabase database;
+    if (!database.load(databasePath)) {
+        std::cerr << "No se pudo leer la base de sketches (o es de otra precision o politica de hash): " << databasePath << std::endl;
+        return 1;
+    }
+
+    if (useTree) {
+        ThreadPool pool(threads);
+        SketchSearcher searcher(database, pool);
+        VpTree tree;
+        tree.build(searcher, pool);
+        std::string treePath = databasePath + ".vpt";
+        if (!tree.save(treePath)) {
+            std::cerr << "No se pudo escribir " << treePath << std::endl;
+            return 1;
+        }
+        std::cerr << "Se guardo el arbol de " << tree.size() << " sketches en " << treePath << std::endl;
+        return 0;
+    }
+
+    LshIndex index;
+    index.build(database, bands, rows);
+    std::string indexPath = databasePath + ".lsh";
+    if (!index.save(indexPath)) {
+        std::cerr << "No se pudo escribir " << indexPath << std::endl;
+        return 1;
+    }
+    std::cerr << "Se guardo el indice de " << index.size() << " sketches en " << indexPath << std::endl;
+    return 0;
+}
+
+// Comando por defecto: Jaccard real y estimado entre pares de genomas
+int runCompare(int argc, char* argv[], const char* program) {
+    std::vector<std::string> filenames;
     int numGenomes = 5;  // Procesar al menos 5 genomas
     int k = 20;  // Valor de k para los k-mers
+    int minAbundance = 1;  // 1 = sin filtro de abundancia
+    uint64_t expectedKmers = AbundanceFilter::defaultExpectedKmers;
+    bool pooled = false;
+    bool canonical = false;
+    KmerSampling sampling;
+    long scaled = 0;  // 0 = sin FracMinHash
+    int minHashBits = 0;  // 0 = sin MinHash
+    int slotBits = 0;     // 0 = sin MinHash de b bits
+
+    int option;
+    while ((option = getopt(argc, argv, "n:k:a:e:rCw:s:f:m:b:")) != -1) {
+        switch (option) {
+            case 'm': minHashBits = std::atoi(optarg); break;
+            case 'b': slotBits = std::atoi(optarg); break;
+            case 'f': scaled = std::atol(optarg); break;
+            case 'C': canonical = true; break;
+            case 'w': sampling = KmerSampling(KmerSampling::Minimizers, std::atoi(optarg)); break;
+            case 's': sampling = KmerSampling(KmerSampling::Syncmers, std::atoi(optarg)); break;
+            case 'n': numGenomes = std::atoi(optarg); break;
+            case 'k': k = std::atoi(optarg); break;
+            case 'a': minAbundance = std::atoi(optarg); break;
+            case 'e': expectedKmers = parseMillions(optarg); break;
+            case 'r': pooled = true; break;
+            default: printUsage(program); return 1;
+        }
+    }
+    for (int i = optind; i < argc; ++i) {
+        filenames.push_back(argv[i]);
+    }
+    if (filenames.empty()) {
+        filenames.push_back("GCF_001969825.1_ASM196982v1_genomic.fna");
+    }
+    bool sampled = sampling.mode != KmerSampling::AllKmers;
+    if (!validExpectedKmers(expectedKmers)) return 1;
+    if (numGenomes < 2 || k < 1 || k > 64 || minAbundance < 1 || (k > 32 && minAbundance > 1) ||
+        !validSampling(sampling, k) || (sampled && minAbundance > 1) || scaled < 0 ||
+        (minHashBits != 0 && (minHashBits < 4 || minHashBits > 24)) ||
+        (slotBits != 0 && (minHashBits == 0 || slotBits < 1 || slotBits > 32))) {
+        printUsage(program);
+        return 1;
+    }
 
-    // Leer los genomas del archivo
-    std::vector<std::string> genomes = readGenomesFromFile(filename, numGenomes);
+    // Leer los genomas empaquetados y luego generar sus k-mers
+    std::vector<GenomeSketch> genomes;
+    std::unique_ptr<AbundanceFilter> filter;
+    if (minAbundance > 1) {
+        filter.reset(new AbundanceFilter(minAbundance, expectedKmers));
+    }
+    GenomeCollector collector(genomes, numGenomes, pooled);
+    for (const auto& filename : filenames) {
+        collector.beginFile(filename);
+        if (!readSequenceFile(filename, collector)) {
+            std::cerr << "No se pudo leer el archivo: " << filename << std::endl;
+            return 1;
+        }
+        if (!collector.endFile()) break;
+    }
+    for (auto& genome : genomes) {
+        buildKmers(genome, k, filter.get(), canonical, sampling, scaled, minHashBits);
+    }
+    std::vector<BBitMinHash> slotSketches;
+    if (slotBits > 0) {
+        for (const auto& genome : genomes) {
+            slotSketches.push_back(BBitMinHash(genome.minHash, slotBits));
+        }
+    }
 
     if (genomes.size() < 2) {
         std::cerr << "No hay suficientes genomas para comparar." << std::endl;
@@ -113,31 +763,80 @@ int main() {
         for (size_t j = i + 1; j < genomes.size(); ++j) {
             std::cout << "Comparando genoma " << i + 1 << " con genoma " << j + 1 << std::endl;
 
-            // Generamos los k-mers para ambos genomas
-            auto kmersA = generateKMers(genomes[i], k);
-            auto kmersB = generateKMers(genomes[j], k);
-
             // Calcular Jaccard real
-            double realJ = realJaccard(kmersA, kmersB);
+            double realJ = k > 32 ? realJaccard(genomes[i].wideKmers, genomes[j].wideKmers)
+                                  : realJaccard(genomes[i].kmers, genomes[j].kmers);
             std::cout << "Similitud de Jaccard real entre genoma " << i + 1 << " y genoma " << j + 1 << ": " << realJ << std::endl;
 
-            // Creamos instancias de HyperLogLog para cada genoma
-            HyperLogLog hllA, hllB;
-            for (const auto& kmer : kmersA) {
-                hllA.add(kmer);
-            }
-            for (const auto& kmer : kmersB) {
-                hllB.add(kmer);
-            }
-
             // Calcular Jaccard estimado
-            double estimatedJ = jaccardSimilarity(hllA, hllB);
+            double estimatedJ = jaccardSimilarity(genomes[i].hll, genomes[j].hll);
+            if (sampled) {
+                // Con muestreo el HyperLogLog estima el Jaccard entre los k-mers
+                // elegidos; se corrige para compararlo con el de todos los k-mers
+                std::cout << "Similitud de Jaccard estimada (espacio muestreado) entre genoma " << i + 1 << " y genoma " << j + 1 << ": " << estimatedJ << std::endl;
+                estimatedJ = sampling.correctJaccard(estimatedJ, k);
+            }
             std::cout << "Similitud de Jaccard estimada entre genoma " << i + 1 << " y genoma " << j + 1 << ": " << estimatedJ << std::endl;
 
             // Calcular y mostrar errores
             CalculodeErrores(realJ, estimatedJ);
+
+            // Contencion del genoma con menos k-mers en el otro: a diferencia de
+            // Jaccard sigue siendo informativa si los tamaños son muy distintos
+            size_t sizeI = k > 32 ? genomes[i].wideKmers.size() : genomes[i].kmers.size();
+            size_t sizeJ = k > 32 ? genomes[j].wideKmers.size() : genomes[j].kmers.size();
+            size_t small = sizeI <= sizeJ ? i : j;
+            size_t large = small == i ? j : i;
+            double realC = k > 32 ? realContainment(genomes[small].wideKmers, genomes[large].wideKmers)
+                                  : realContainment(genomes[small].kmers, genomes[large].kmers);
+            std::cout << "Contencion real del genoma " << small + 1 << " en el genoma " << large + 1 << ": " << realC << std::endl;
+            if (sampled) {
+                // Se consultan los k-mers muestreados del pequeño en el indice del grande
+                double sampledC = containment(genomes[small].sampledKmers, genomes[large].sampledIndex);
+                std::cout << "Contencion estimada (espacio muestreado) del genoma " << small + 1 << " en el genoma " << large + 1 << ": " << sampledC << std::endl;
+                std::cout << "Contencion estimada del genoma " << small + 1 << " en el genoma " << large + 1 << ": " << sampling.correctContainment(sampledC, k) << std::endl;
+            }
+            if (scaled > 0) {
+                double fracJ, fracC;
+                if (!genomes[i].fracMinHash.jaccard(genomes[j].fracMinHash, fracJ) ||
+                    !genomes[small].fracMinHash.containment(genomes[large].fracMinHash, fracC)) {
+                    std::cerr << "Los sketches FracMinHash tienen distinto scaled" << std::endl;
+                    return 1;
+                }
+                std::cout << "Similitud de Jaccard estimada (FracMinHash) entre genoma " << i + 1 << " y genoma " << j + 1 << ": " << fracJ << std::endl;
+                std::cout << "Contencion estimada (FracMinHash) del genoma " << small + 1 << " en el genoma " << large + 1 << ": " << fracC << std::endl;
+            }
+            if (minHashBits > 0) {
+                double minHashJ;
+                if (!genomes[i].minHash.jaccard(genomes[j].minHash, minHashJ)) {
+                    std::cerr << "Los sketches MinHash tienen distinta cantidad de bins" << std::endl;
+                    return 1;
+                }
+                std::cout << "Similitud de Jaccard estimada (MinHash) entre genoma " << i + 1 << " y genoma " << j + 1 << ": " << minHashJ << std::endl;
+            }
+            if (slotBits > 0) {
+                double slotJ;
+                if (!slotSketches[i].jaccard(slotSketches[j], slotJ)) {
+                    std::cerr << "Las firmas MinHash de b bits tienen distinto b o cantidad de bins" << std::endl;
+                    return 1;
+                }
+                std::cout << "Similitud de Jaccard estimada (MinHash de " << slotBits << " bits) entre genoma " << i + 1 << " y genoma " << j + 1 << ": " << slotJ << std::endl;
+            }
         }
     }
 
     return 0;
 }
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "sketch") {
+        return runSketch(argc - 1, argv + 1, argv[0]);
+    }
+    if (argc > 1 && std::string(argv[1]) == "query") {
+        return runQuery(argc - 1, argv + 1, argv[0]);
+    }
+    if (argc > 1 && std::string(argv[1]) == "index") {
+        return runIndex(argc - 1, argv + 1, argv[0]);
+    }
+    return runCompare(argc, argv, argv[0]);
+}
@@ -0,0 +1,136 @@
+#ifndef KMER_H
+#define KMER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Codigo de 2 bits de cada caracter: A/a=0, C/c=1, G/g=2, T/t=3 y 4 para
+// cualquier otro caracter (N y demas codigos IUPAC)
+extern const uint8_t baseCode[256];
+
+// Codificador rodante de k-mers (k <= 32) para una secuencia que llega por
+// tramos (las lineas de un archivo FASTA o los bloques de un .gz) sin
+// concatenarla: el estado entre tramos es solo el codigo actual. Cada base se
+// traduce con la tabla baseCode; al encontrar una base ambigua se reinicia la
+// ventana y se salta el tramo ambiguo completo en un ciclo aparte, de modo que
+// el ciclo principal solo tiene una rama casi siempre predicha.
+class KmerEncoder {
+private:
+    int k;
+    bool canonical;
+    uint64_t mask;
+    int topShift;
+    uint64_t code;
+    uint64_t reverse;  // Reverso complementario de la ventana
+    int valid;         // Bases validas consecutivas en la ventana
+
+public:
+    explicit KmerEncoder(int k, bool canonical = false)
+        : k(k), canonical(canonical), mask(k == 32 ? ~uint64_t(0) : (uint64_t(1) << (2 * k)) - 1),
+          topShift(2 * k - 2), code(0), reverse(0), valid(0) {}
+
+    // Olvidar las bases anteriores (inicio de un nuevo registro)
+    void reset() {
+        code = 0;
+        reverse = 0;
+        valid = 0;
+    }
+
+    // Procesar un tramo llamando sink(codigo) por cada k-mer sin bases
+    // ambiguas; el codigo tiene la primera base en los bits mas altos. Con
+    // `canonical` se entrega el menor entre el k-mer y su reverso complementario
+    template <typename Sink>
+    void feed(const char *data, size_t length, Sink &sink) {
+        const unsigned char *bases = reinterpret_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < length; ++i) {
+            uint64_t base = baseCode[bases[i]];
+            if (base > 3) {
+                valid = 0;
+                while (i + 1 < length && baseCode[bases[i + 1]] > 3) ++i;
+                continue;
+            }
+            code = ((code << 2) | base) & mask;
+            valid += valid < k;  // Acotado para registros de mas de 2^31 bases
+            if (canonical) {
+                reverse = (reverse >> 2) | ((3 - base) << topShift);
+                if (valid == k) sink(reverse < code ? reverse : code);
+            } else if (valid == k) {
+                sink(code);
+            }
+        }
+    }
+};
+
+// Codificador rodante para varios k a la vez (todos <= 32) en una sola pasada:
+// se mantiene la ventana del k mas largo y cada k-mer mas corto que termina en
+// la misma posicion son sus ultimos 2k bits, asi que basta una mascara. Su
+// reverso complementario son los primeros 2k bits del reverso de la ventana
+// larga, que se obtienen con un desplazamiento.
+class MultiKmerEncoder {
+private:
+    std::vector<int> ks;
+    std::vector<uint64_t> masks;
+    std::vector<int> shifts;
+    bool canonical;
+    int maxK;
+    uint64_t maxMask;
+    uint64_t code;
+    uint64_t reverse;
+    int valid;
+
+    static uint64_t maskFor(int k) {
+        return k == 32 ? ~uint64_t(0) : (uint64_t(1) << (2 * k)) - 1;
+    }
+
+public:
+    explicit MultiKmerEncoder(const std::vector<int> &ks, bool canonical = false)
+        : ks(ks), canonical(canonical), maxK(0), code(0), reverse(0), valid(0) {
+        for (size_t i = 0; i < ks.size(); ++i) {
+            masks.push_back(maskFor(ks[i]));
+            if (ks[i] > maxK) maxK = ks[i];
+        }
+        for (size_t i = 0; i < ks.size(); ++i) {
+            shifts.push_back(2 * (maxK - ks[i]));
+        }
+        maxMask = maskFor(maxK);
+    }
+
+    void reset() {
+        code = 0;
+        reverse = 0;
+        valid = 0;
+    }
+
+    // Igual que KmerEncoder::feed, pero llama sink(i, codigo) con el k-mer de
+    // largo ks[i] para cada i cuya ventana ya esta completa
+    template <typename Sink>
+    void feed(const char *data, size_t length, Sink &sink) {
+        const unsigned char *bases = reinterpret_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < length; ++i) {
+            uint64_t base = baseCode[bases[i]];
+            if (base > 3) {
+                valid = 0;
+                while (i + 1 < length && baseCode[bases[i + 1]] > 3) ++i;
+                continue;
+            }
+            code = ((code << 2) | base) & maxMask;
+            valid += valid < maxK;
+            if (canonical) {
+                reverse = (reverse >> 2) | ((3 - base) << (2 * maxK - 2));
+                for (size_t j = 0; j < ks.size(); ++j) {
+                    if (valid < ks[j]) continue;
+                    uint64_t forward = code & masks[j];
+                    uint64_t backward = reverse >> shifts[j];
+                    sink(j, backward < forward ? backward : forward);
+                }
+            } else {
+                for (size_t j = 0; j < ks.size(); ++j) {
+                    if (valid >= ks[j]) sink(j, code & masks[j]);
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef KMER128_H
+#define KMER128_H
+
+#include <cstddef>
+#include <cstdint>
+#include "kmer.h"
+#include "kmerhash.h"
+
+// K-mer de hasta 64 bases codificado a 2 bits por base en dos palabras: `lo`
+// tiene las ultimas 32 bases y `hi` las anteriores, con la primera base en los
+// bits mas altos usados, igual que los codigos de 64 bits de KmerEncoder.
+struct Kmer128 {
+    uint64_t hi;
+    uint64_t lo;
+
+    bool operator==(const Kmer128 &other) const { return hi == other.hi && lo == other.lo; }
+    bool operator!=(const Kmer128 &other) const { return !(*this == other); }
+    bool operator<(const Kmer128 &other) const {
+        return hi < other.hi || (hi == other.hi && lo < other.lo);
+    }
+};
+
+// Hash de 64 bits de un k-mer de dos palabras: se mezcla `hi` y el resultado
+// sirve de semilla para mezclar `lo`. Para un `hi` fijo es biyectivo en `lo`.
+inline uint64_t hashKmer128(const Kmer128 &kmer, uint64_t seed = 0) {
+    return kmerHash64(kmer.lo, kmerHash64(kmer.hi, seed));
+}
+
+// Functor para usar Kmer128 en std::unordered_set
+struct Kmer128Hasher {
+    size_t operator()(const Kmer128 &kmer) const { return static_cast<size_t>(hashKmer128(kmer)); }
+};
+
+// Estado rodante de un k-mer de hasta 64 bases y de su reverso complementario
+class Kmer128Roller {
+private:
+    uint64_t hiMask;
+    uint64_t loMask;
+    int topShift;  // Posicion (en bits) de la primera base del k-mer
+    Kmer128 forward;
+    Kmer128 reverse;
+
+public:
+    explicit Kmer128Roller(int k)
+        : hiMask(k <= 32 ? 0 : k == 64 ? ~uint64_t(0) : (uint64_t(1) << (2 * k - 64)) - 1),
+          loMask(k >= 32 ? ~uint64_t(0) : (uint64_t(1) << (2 * k)) - 1),
+          topShift(2 * k - 2) {
+        reset();
+    }
+
+    void reset() {
+        forward.hi = forward.lo = 0;
+        reverse.hi = reverse.lo = 0;
+    }
+
+    // Agregar una base (0 a 3) al final del k-mer
+    void push(uint64_t base) {
+        forward.hi = ((forward.hi << 2) | (forward.lo >> 62)) & hiMask;
+        forward.lo = ((forward.lo << 2) | base) & loMask;
+
+        // El complemento de la base nueva entra por el principio del reverso
+        reverse.lo = (reverse.lo >> 2) | (reverse.hi << 62);
+        reverse.hi >>= 2;
+        if (topShift >= 64) {
+            reverse.hi |= (3 - base) << (topShift - 64);
+        } else {
+            reverse.lo |= (3 - base) << topShift;
+        }
+    }
+
+    const Kmer128 &forwardKmer() const { return forward; }
+    const Kmer128 &reverseKmer() const { return reverse; }
+
+    // El menor entre el k-mer y su reverso complementario
+    const Kmer128 &canonicalKmer() const { return reverse < forward ? reverse : forward; }
+};
+
+// Codificador rodante de k-mers de hasta 64 bases con la misma interfaz que
+// KmerEncoder: sink(kmer) recibe cada k-mer sin bases ambiguas, en su forma
+// canonica si se pide.
+class Kmer128Encoder {
+private:
+    int k;
+    bool canonical;
+    Kmer128Roller roller;
+    int valid;
+
+public:
+    explicit Kmer128Encoder(int k, bool canonical = false)
+        : k(k), canonical(canonical), roller(k), valid(0) {}
+
+    void reset() {
+        roller.reset();
+        valid = 0;
+    }
+
+    template <typename Sink>
+    void feed(const char *data, size_t length, Sink &sink) {
+        const unsigned char *bases = reinterpret_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < length; ++i) {
+            uint64_t base = baseCode[bases[i]];
+            if (base > 3) {
+                valid = 0;
+                while (i + 1 < length && baseCode[bases[i + 1]] > 3) ++i;
+                continue;
+            }
+            roller.push(base);
+            valid += valid < k;
+            if (valid == k) {
+                sink(canonical ? roller.canonicalKmer() : roller.forwardKmer());
+            }
+        }
+    }
+};
+
+#endif
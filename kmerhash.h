@@ -0,0 +1,18 @@
+#ifndef KMERHASH_H
+#define KMERHASH_H
+
+#include <cstdint>
+
+// Hash de un k-mer ya codificado en una palabra de 64 bits (2 bits por base).
+// Es el finalizador de SplitMix64 aplicado a codigo ^ semilla: dos
+// multiplicaciones y tres xor-shift, sin ciclos ni lecturas de memoria. Para
+// una semilla fija es una biyeccion de 64 bits, asi que dos k-mers distintos
+// nunca chocan antes de truncar el resultado.
+inline uint64_t kmerHash64(uint64_t code, uint64_t seed = 0) {
+    uint64_t h = (code ^ seed) + 0x9e3779b97f4a7c15ULL;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef KMERINDEX_H
+#define KMERINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "kmerhash.h"
+
+// Conjunto de k-mers (k <= 32, codificados a 2 bits por base) en una tabla
+// plana con direccionamiento abierto y sondeo lineal: 8 bytes por casilla y a
+// lo mas la mitad ocupada, sin nodos ni punteros como std::unordered_set. Una
+// consulta es un hash y en promedio menos de dos lecturas contiguas. El codigo
+// con todos los bits en 1 (TTT...T con k = 32) marca las casillas vacias y se
+// guarda aparte.
+class KmerIndex {
+private:
+    static const uint64_t emptySlot = ~uint64_t(0);
+
+    std::vector<uint64_t> slots;
+    uint64_t mask;
+    size_t count;
+    bool hasEmptyCode;
+
+    size_t slotFor(uint64_t code) const { return static_cast<size_t>(kmerHash64(code) & mask); }
+
+    void rehash(size_t capacity) {
+        std::vector<uint64_t> old;
+        old.swap(slots);
+        slots.assign(capacity, uint64_t(emptySlot));
+        mask = capacity - 1;
+        for (uint64_t code : old) {
+            if (code == emptySlot) continue;
+            size_t slot = slotFor(code);
+            while (slots[slot] != emptySlot) slot = (slot + 1) & mask;
+            slots[slot] = code;
+        }
+    }
+
+public:
+    KmerIndex() : mask(0), count(0), hasEmptyCode(false) {}
+
+    // Agregar un k-mer; retorna false si ya estaba
+    bool insert(uint64_t code) {
+        if (code == emptySlot) {
+            if (hasEmptyCode) return false;
+            hasEmptyCode = true;
+            ++count;
+            return true;
+        }
+        if (2 * (count + 1) > slots.size()) rehash(slots.empty() ? 16 : 2 * slots.size());
+        size_t slot = slotFor(code);
+        while (slots[slot] != emptySlot) {
+            if (slots[slot] == code) return false;
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = code;
+        ++count;
+        return true;
+    }
+
+    bool contains(uint64_t code) const {
+        if (code == emptySlot) return hasEmptyCode;
+        if (slots.empty()) return false;
+        size_t slot = slotFor(code);
+        while (slots[slot] != emptySlot) {
+            if (slots[slot] == code) return true;
+            slot = (slot + 1) & mask;
+        }
+        return false;
+    }
+
+    size_t size() const { return count; }
+
+    size_t memoryBytes() const { return slots.size() * sizeof(uint64_t); }
+};
+
+// Contencion de A en B, |A n B| / |A|, con A dado por sus k-mers (sin
+// repetir) y B por su indice. Conviene que A sea el conjunto pequeño: el costo
+// es una consulta por k-mer de A, sin importar el tamaño de B.
+template <typename KmerList>
+double containment(const KmerList &kmersA, const KmerIndex &indexB) {
+    size_t shared = 0;
+    size_t total = 0;
+    for (uint64_t code : kmersA) {
+        shared += indexB.contains(code);
+        ++total;
+    }
+    return total > 0 ? static_cast<double>(shared) / total : 0.0;
+}
+
+#endif
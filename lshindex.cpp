@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "Spooky.h"
+#include "lshindex.h"
+
+static const char indexMagic[8] = { 'H', 'L', 'L', 'L', 'S', 'H', '0', '2' };
+
+template <typename T>
+static void writeValue(std::ostream &out, T value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool readValue(std::istream &in, T &value) {
+    in.read(reinterpret_cast<char *>(&value), sizeof(value));
+    return static_cast<bool>(in);
+}
+
+bool LshIndex::validShape(int bands, int rows) {
+    return bands >= 1 && rows >= 1 && (int64_t(bands) * rows) <= (int64_t(1) << HyperLogLog::precision());
+}
+
+// La semilla distingue bandas con los mismos valores en otra posicion
+bool LshIndex::bandKey(const HyperLogLog &sketch, int band, std::vector<uint8_t> &values, uint64_t &key) const {
+    const uint8_t *registers = sketch.registerData();
+    size_t stride = (size_t(1) << HyperLogLog::precision()) / (size_t(bands) * rows);
+    values.resize(rows);
+    uint8_t any = 0;
+    for (int i = 0; i < rows; ++i) {
+        values[i] = registers[(size_t(i) * bands + band) * stride];
+        any |= values[i];
+    }
+    if (any == 0) return false;
+    key = SpookyHash::Hash64(values.data(), rows, band);
+    return true;
+}
+
+void LshIndex::build(const SketchDatabase &database, int bands, int rows) {
+    this->bands = bands;
+    this->rows = rows;
+    references = database.sketches.size();
+    offsets.assign(1, 0);
+    keys.clear();
+    ids.clear();
+
+    std::vector<uint8_t> values;
+    std::vector<std::pair<uint64_t, uint32_t> > entries;
+    for (int band = 0; band < bands; ++band) {
+        entries.clear();
+        for (size_t i = 0; i < references; ++i) {
+            uint64_t key;
+            if (bandKey(database.sketches[i], band, values, key)) {
+                entries.push_back(std::make_pair(key, static_cast<uint32_t>(i)));
+            }
+        }
+        std::sort(entries.begin(), entries.end());
+
+        for (const auto &entry : entries) {
+            keys.push_back(entry.first);
+            ids.push_back(entry.second);
+        }
+        offsets.push_back(keys.size());
+    }
+}
+
+bool LshIndex::save(const std::string &filename) const {
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    if (!out) return false;
+
+    out.write(indexMagic, sizeof(indexMagic));
+    writeHashPolicy(out);
+    writeValue<int32_t>(out, bands);
+    writeValue<int32_t>(out, rows);
+    writeValue<uint64_t>(out, references);
+    for (int band = 0; band < bands; ++band) {
+        uint64_t begin = offsets[band], count = offsets[band + 1] - begin;
+        writeValue<uint64_t>(out, count);
+        out.write(reinterpret_cast<const char *>(keys.data() + begin), count * sizeof(uint64_t));
+        out.write(reinterpret_cast<const char *>(ids.data() + begin), count * sizeof(uint32_t));
+    }
+    return static_cast<bool>(out);
+}
+
+bool LshIndex::load(const std::string &filename, uint64_t expectedReferences) {
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    if (!in) return false;
+
+    char magic[sizeof(indexMagic)];
+    int32_t storedBands, storedRows;
+    uint64_t count;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, indexMagic, sizeof(magic)) != 0) return false;
+    if (!readHashPolicy(in)) return false;
+    if (!readValue(in, storedBands) || !readValue(in, storedRows) || !readValue(in, count)) return false;
+    if (!validShape(storedBands, storedRows) || count != expectedReferences) return false;
+
+    bands = storedBands;
+    rows = storedRows;
+    references = count;
+    offsets.assign(1, 0);
+    keys.clear();
+    ids.clear();
+    for (int band = 0; band < bands; ++band) {
+        // Cada referencia tiene a lo mas una clave por banda
+        uint64_t bandCount;
+        if (!readValue(in, bandCount) || bandCount > references) return false;
+        size_t begin = keys.size();
+        keys.resize(begin + bandCount);
+        ids.resize(begin + bandCount);
+        in.read(reinterpret_cast<char *>(keys.data() + begin), bandCount * sizeof(uint64_t));
+        in.read(reinterpret_cast<char *>(ids.data() + begin), bandCount * sizeof(uint32_t));
+        if (!in) return false;
+        for (size_t i = begin; i < keys.size(); ++i) {
+            if (ids[i] >= references || (i > begin && keys[i] < keys[i - 1])) return false;
+        }
+        offsets.push_back(keys.size());
+    }
+    return true;
+}
+
+std::vector<size_t> LshIndex::candidates(const HyperLogLog &query) const {
+    std::vector<size_t> found;
+    std::vector<uint8_t> values;
+    for (int band = 0; band < bands; ++band) {
+        uint64_t key;
+        if (!bandKey(query, band, values, key)) continue;
+        const uint64_t *begin = keys.data() + offsets[band];
+        const uint64_t *end = keys.data() + offsets[band + 1];
+
+        const uint64_t *match = std::lower_bound(begin, end, key);
+        for (; match != end && *match == key; ++match) {
+            found.push_back(ids[match - keys.data()]);
+        }
+    }
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+    return found;
+}
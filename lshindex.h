@@ -0,0 +1,65 @@
+#ifndef LSHINDEX_H
+#define LSHINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "hyperloglog.h"
+#include "sketchdb.h"
+
+// Indice LSH por bandas sobre los registros de los sketches de una
+// SketchDatabase. Las bandas se reparten por todo el arreglo de m registros:
+// la fila i de la banda j es el registro (i * bands + j) * (m / (bands * rows)),
+// y la clave de la banda es el hash de esos bytes. Un registro de la union cae
+// en la interseccion con probabilidad J, y en ese caso A y B tienen el mismo
+// valor, asi que dos sketches coinciden en un registro con probabilidad q >= J
+// y comparten una banda con probabilidad 1 - (1 - q^rows)^bands. Con 64
+// bandas de 8 registros casi todos los pares con J >= 0.7 son candidatos y
+// los no relacionados (q ~ 0.1 en genomas de megabases) practicamente nunca.
+//
+// En genomas chicos muchos registros quedan en cero y dos sketches chicos
+// coincidirian en esas bandas sin compartir k-mers, asi que las bandas con
+// todos sus registros en cero no tienen clave: ni se guardan ni se consultan.
+// Un genoma con todas sus bandas en cero no es candidato de nadie.
+//
+// Cada banda guarda las claves de sus referencias ordenadas, asi una
+// consulta hace a lo mas `bands` busquedas binarias en vez de recorrer la
+// coleccion. Formato binario: firma "HLLLSH02", politica de hash (ver
+// writeHashPolicy), bandas y filas (int32), cantidad de referencias (uint64)
+// y luego, por banda, cuantas claves tiene (uint64), las claves (uint64) y
+// los indices de referencia (uint32) en el mismo orden.
+class LshIndex {
+private:
+    int bands;
+    int rows;
+    uint64_t references;
+    std::vector<uint64_t> offsets;  // Claves de la banda j en [offsets[j], offsets[j + 1])
+    std::vector<uint64_t> keys;     // Ordenadas dentro de cada banda
+    std::vector<uint32_t> ids;      // Referencia de cada clave
+
+    // Clave de la banda en `key`; false si todos sus registros son cero
+    bool bandKey(const HyperLogLog &sketch, int band, std::vector<uint8_t> &values, uint64_t &key) const;
+
+public:
+    LshIndex() : bands(0), rows(0), references(0) {}
+
+    // bands * rows no puede superar la cantidad de registros
+    static bool validShape(int bands, int rows);
+
+    void build(const SketchDatabase &database, int bands, int rows);
+
+    bool save(const std::string &filename) const;
+
+    // Retorna false si el archivo no existe, esta truncado, usa otra politica
+    // de hash o no corresponde a una base de `expectedReferences` sketches
+    bool load(const std::string &filename, uint64_t expectedReferences);
+
+    uint64_t size() const { return references; }
+
+    // Referencias que comparten al menos una banda con la consulta, sin
+    // repetir y en orden creciente
+    std::vector<size_t> candidates(const HyperLogLog &query) const;
+};
+
+#endif
@@ -66,6 +66,8 @@ HashInfo g_hashes[] =
   { SpookyHash64_test,    64, 0xA7F955F1, "Spooky64",    "Bob Jenkins' SpookyHash, 64-bit result" },
   { SpookyHash128_test,  128, 0x8D263080, "Spooky128",   "Bob Jenkins' SpookyHash, 128-bit result" },
 
+  { KmerHash64_test,      64, 0xF46FE0D9, "KmerHash64",  "SplitMix64 finalizer for 2-bit packed k-mers, 8-byte blocks" },
+
   // MurmurHash2
 
   { MurmurHash2_test,     32, 0x27864C1E, "Murmur2",     "MurmurHash2 for x86, 32-bit" },
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include "minhash.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+MinHash::MinHash(int bits) : bits(bits), bins(size_t(1) << bits, uint32_t(emptyBin)), densified(false) {}
+
+// Pruebas por bin vacio antes de recurrir al recorrido
+static const uint64_t maxProbes = 4;
+
+void MinHash::densify(std::vector<uint32_t> &out) const {
+    out = bins;
+    size_t count = bins.size();
+
+    // Las pruebas caen en posiciones al azar: se revisan en un mapa de bits de
+    // los bins ocupados (2 MB con 2^24 bins) en vez de en los bins
+    std::vector<uint64_t> occupied((count + 63) / 64, 0);
+    size_t firstOccupied = count;
+    for (size_t i = count; i-- > 0;) {
+        if (bins[i] == emptyBin) continue;
+        occupied[i / 64] |= uint64_t(1) << (i % 64);
+        firstOccupied = i;
+    }
+    if (firstOccupied == count) return;
+
+    // Se recorre de derecha a izquierda recordando el siguiente bin ocupado
+    // (circular), que es el respaldo si ninguna prueba da con uno ocupado
+    size_t next = firstOccupied;
+    for (size_t i = count; i-- > 0;) {
+        if (bins[i] != emptyBin) {
+            next = i;
+            continue;
+        }
+        // Las pruebas dependen solo de i y del intento, nunca de los datos
+        size_t source = next;
+        for (uint64_t attempt = 1; attempt <= maxProbes; ++attempt) {
+            size_t probe = static_cast<size_t>(kmerHash64((uint64_t(i) << 32) | attempt) >> (64 - bits));
+            if (occupied[probe / 64] >> (probe % 64) & 1) {
+                source = probe;
+                break;
+            }
+        }
+        out[i] = bins[source];
+    }
+}
+
+void MinHash::finish() {
+    if (densified) return;
+    densify(signature);
+    densified = true;
+}
+
+std::vector<uint32_t> MinHash::densifiedSignature() const {
+    if (densified) return signature;
+    std::vector<uint32_t> out;
+    densify(out);
+    return out;
+}
+
+bool MinHash::empty() const {
+    if (densified) return signature[0] == emptyBin;
+    return std::count(bins.begin(), bins.end(), uint32_t(emptyBin)) == std::ptrdiff_t(bins.size());
+}
+
+bool MinHash::merge(const MinHash &other) {
+    if (other.bins.size() != bins.size()) return false;
+    for (size_t i = 0; i < bins.size(); ++i) {
+        bins[i] = std::min(bins[i], other.bins[i]);
+    }
+    densified = false;
+    return true;
+}
+
+bool MinHash::jaccard(const MinHash &other, double &result) const {
+    if (other.bins.size() != bins.size()) return false;
+
+    // Un sketch sin terminar se densifica en una copia
+    std::vector<uint32_t> ownCopy, otherCopy;
+    if (!densified) densify(ownCopy);
+    if (!other.densified) other.densify(otherCopy);
+    const std::vector<uint32_t> &a = densified ? signature : ownCopy;
+    const std::vector<uint32_t> &b = other.densified ? other.signature : otherCopy;
+
+    // Dos sketches vacios no comparten nada
+    if (a[0] == emptyBin || b[0] == emptyBin) {
+        result = 0.0;
+    } else {
+        result = static_cast<double>(countEqual(a.data(), b.data(), a.size())) / a.size();
+    }
+    return true;
+}
+
+size_t countEqual(const uint32_t *a, const uint32_t *b, size_t count) {
+    size_t equal = 0;
+    size_t i = 0;
+#ifdef __SSE2__
+    // Cada posicion igual da -1 en su carril; se restan de a 4 contadores y se
+    // suman al final (count < 2^32 por carril)
+    __m128i counts = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        counts = _mm_sub_epi32(counts, _mm_cmpeq_epi32(x, y));
+    }
+    uint32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), counts);
+    equal = size_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < count; ++i) {
+        equal += a[i] == b[i];
+    }
+    return equal;
+}
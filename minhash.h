@@ -0,0 +1,84 @@
+#ifndef MINHASH_H
+#define MINHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "kmer128.h"
+#include "kmerhash.h"
+
+// MinHash de una permutacion (one permutation hashing): el hash de 64 bits de
+// cada k-mer elige uno de los 2^b bins con sus b bits altos, y el bin guarda
+// el minimo de los 32 bits siguientes. Cada k-mer cuesta un hash y una
+// comparacion, O(n) en total en vez de los O(n * s) del MinHash clasico con s
+// permutaciones.
+//
+// Los bins que quedan vacios (genomas chicos o muchos bins) se rellenan con
+// la densificacion optima de Shrivastava (2017): el bin vacio i prueba los
+// bins h(i, 1), h(i, 2), ... hasta dar con uno ocupado y copia su valor. Como
+// la secuencia de pruebas depende solo de i, dos sketches con los mismos bins
+// ocupados copian de los mismos lugares y la probabilidad de que un bin
+// coincida sigue siendo el Jaccard. Con muchos mas bins que k-mers casi
+// todas las pruebas fallan, asi que tras 4 pruebas el bin copia del
+// siguiente bin ocupado a su derecha (circular), que tambien depende solo de
+// los bins ocupados; asi densificar cuesta a lo mas 4 hashes por bin.
+//
+// Sketches con distinta cantidad de bins no se pueden comparar: merge y
+// jaccard retornan false sin tocar nada si no coinciden.
+//
+// La firma densificada se guarda con finish(), despues del ultimo k-mer; las
+// consultas (metodos const) no modifican el sketch y con uno sin terminar
+// densifican una copia.
+class MinHash {
+private:
+    static const uint32_t emptyBin = ~uint32_t(0);
+
+    int bits;
+    std::vector<uint32_t> bins;       // Minimo de cada bin (emptyBin si vacio)
+    std::vector<uint32_t> signature;  // Bins densificados, valida si `densified`
+    bool densified;
+
+    void densify(std::vector<uint32_t> &out) const;
+
+public:
+    // 2^bits bins (4 <= bits <= 24)
+    explicit MinHash(int bits = 10);
+
+    void addHash(uint64_t hashValue) {
+        size_t bin = static_cast<size_t>(hashValue >> (64 - bits));
+        uint32_t value = static_cast<uint32_t>(hashValue >> (32 - bits));
+        if (value == emptyBin) value = emptyBin - 1;
+        if (value < bins[bin]) {
+            bins[bin] = value;
+            densified = false;
+        }
+    }
+
+    void addKmer(uint64_t code) { addHash(kmerHash64(code)); }
+
+    void addKmer(const Kmer128 &kmer) { addHash(hashKmer128(kmer)); }
+
+    // Guardar la firma densificada
+    void finish();
+
+    // Unir con un sketch de la misma cantidad de bins
+    bool merge(const MinHash &other);
+
+    size_t binCount() const { return bins.size(); }
+
+    // Firma densificada: un valor de 32 bits por bin (todos emptyBin si no se
+    // agrego ningun k-mer)
+    std::vector<uint32_t> densifiedSignature() const;
+
+    // Sin ningun k-mer agregado
+    bool empty() const;
+
+    // Jaccard estimado: fraccion de bins iguales en las firmas densificadas
+    bool jaccard(const MinHash &other, double &result) const;
+};
+
+// Cantidad de posiciones i < count con a[i] == b[i], comparando de a 4 con
+// SSE2 cuando esta disponible
+size_t countEqual(const uint32_t *a, const uint32_t *b, size_t count);
+
+#endif
@@ -2,9 +2,14 @@
 #include <fstream>
 #include <vector>
 #include <string>
-#include <unordered_set>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include "intersection.h"
+#include "minimizer.h"
+#include "minimizerindex.h"
+#include "syncmer.h"
 
 using namespace std;
 
@@ -36,54 +41,40 @@ vector<string> readGenomesFromFile(const string& filename) {
     return genomes;
 }
 
-// Funcion para extraer minimizadores de una secuencia de genoma
-unordered_set<string> extractMinimizers(const string& genome, int k, int w) {
-    unordered_set<string> minimizers;
-    if (genome.size() < k) {
-        return minimizers; // Devuelve set vacio si el genoma es muy corto
-    }
-    for (size_t i = 0; i <= genome.size() - w; ++i) {
-        string window = genome.substr(i, w);
-        string minimizer = window.substr(0, k);
-        for (size_t j = 1; j <= window.size() - k; ++j) {
-            string kmer = window.substr(j, k);
-            if (kmer < minimizer) {
-                minimizer = kmer;
-            }
-        }
-        minimizers.insert(minimizer);
-    }
+// Funcion para extraer minimizadores de una secuencia de genoma (k <= 32),
+// codificados a 2 bits por base. Usa MinimizerFinder, lineal en el largo del
+// genoma; con w = k entrega todos los k-mers. Retorna los minimizadores
+// ordenados y sin repetir, y suma a `selected` la cantidad de posiciones
+// elegidas (para calcular la densidad).
+vector<uint64_t> extractMinimizers(const string& genome, int k, int w, uint64_t& selected) {
+    vector<uint64_t> minimizers;
+    MinimizerFinder finder(k, w);
+    auto sink = [&minimizers](const Minimizer& minimizer) { minimizers.push_back(minimizer.kmer); };
+    finder.feed(genome.data(), genome.size(), sink);
+    selected += minimizers.size();
+    sortUnique(minimizers);
     return minimizers;
 }
 
-// Funcion para calcular Jaccard entre dos conjuntos de minimizadores
-double computeJaccardSimilarity(const unordered_set<string>& set1, const unordered_set<string>& set2) {
-    unordered_set<string> intersection;
-    unordered_set<string> unionSet = set1;
-
-    for (const auto& minimizer : set2) {
-        if (set1.find(minimizer) != set1.end()) {
-            intersection.insert(minimizer);
-        }
-        unionSet.insert(minimizer);
-    }
-
-    return static_cast<double>(intersection.size()) / unionSet.size();
+// Funcion para extraer syncmers (k <= 32): cada k-mer se elige o no segun
+// donde cae su s-mer minimo, sin mirar a sus vecinos. Los abiertos usan el
+// s-mer del medio. Igual que extractMinimizers, retorna los syncmers ordenados
+// y sin repetir.
+vector<uint64_t> extractSyncmers(const string& genome, int k, int s, SyncmerKind kind, uint64_t& selected) {
+    vector<uint64_t> syncmers;
+    SyncmerFinder finder(k, s, kind, (k - s) / 2);
+    auto sink = [&syncmers](const Syncmer& syncmer) { syncmers.push_back(syncmer.kmer); };
+    finder.feed(genome.data(), genome.size(), sink);
+    selected += syncmers.size();
+    sortUnique(syncmers);
+    return syncmers;
 }
 
 // Funcion para calcular el verdadero Jaccard entre dos conjuntos de k-mers
-double computeTrueJaccardSimilarity(const unordered_set<string>& set1, const unordered_set<string>& set2) {
-    unordered_set<string> intersection;
-    unordered_set<string> unionSet = set1;
-
-    for (const auto& kmer : set2) {
-        if (set1.find(kmer) != set1.end()) {
-            intersection.insert(kmer);
-        }
-        unionSet.insert(kmer);
-    }
-
-    return static_cast<double>(intersection.size()) / unionSet.size();
+// ordenados: solo se cuenta la interseccion y la union sale de los tamaños
+double computeTrueJaccardSimilarity(const vector<uint64_t>& set1, const vector<uint64_t>& set2) {
+    size_t shared = intersectionSize(set1, set2);
+    return static_cast<double>(shared) / (set1.size() + set2.size() - shared);
 }
 
 // Funcion para calcular el error relativo medio
@@ -110,10 +101,27 @@ double computeMeanAbsoluteError(const vector<double>& trueValues, const vector<d
     return totalAbsoluteError / trueValues.size();
 }
 
-int main() {
+// Uso: minimizer_sim [-s s | -o s]
+//   -s s  muestrear con syncmers cerrados de s-mers de largo s en vez de minimizadores
+//   -o s  muestrear con syncmers abiertos (s-mer minimo en el medio del k-mer)
+int main(int argc, char* argv[]) {
     string filename = "GCF_001969825.1_ASM196982v1_genomic.fna";
     int k = 20;  // Valor de k para los k-mers
     int w = 30;  // Tamaño de la ventana de los minimizer
+    int s = 0;   // Largo de los s-mers de los syncmers (0 = usar minimizadores)
+    SyncmerKind kind = ClosedSyncmer;
+
+    if (argc == 3 && (string(argv[1]) == "-s" || string(argv[1]) == "-o")) {
+        kind = string(argv[1]) == "-s" ? ClosedSyncmer : OpenSyncmer;
+        s = atoi(argv[2]);
+        if (s < 1 || s > k) {
+            cerr << "El largo de los s-mers debe estar entre 1 y " << k << endl;
+            return 1;
+        }
+    } else if (argc != 1) {
+        cerr << "Uso: " << argv[0] << " [-s s | -o s]" << endl;
+        return 1;
+    }
 
     // Leer los genomas del archivo
     vector<string> genomes = readGenomesFromFile(filename);
@@ -124,17 +132,37 @@ int main() {
     }
 
     // Calcular los minimizadores para cada genoma
-    vector<unordered_set<string>> minimizersList;
+    uint64_t minimizerPositions = 0;
+    vector<vector<uint64_t>> minimizersList;
     for (const auto& genome : genomes) {
-        minimizersList.push_back(extractMinimizers(genome, k, w));
+        if (s > 0) {
+            minimizersList.push_back(extractSyncmers(genome, k, s, kind, minimizerPositions));
+        } else {
+            minimizersList.push_back(extractMinimizers(genome, k, w, minimizerPositions));
+        }
     }
 
     // Calcular los k-mers para cada genoma
-    vector<unordered_set<string>> kmersList;
+    uint64_t kmerPositions = 0;
+    vector<vector<uint64_t>> kmersList;
     for (const auto& genome : genomes) {
-        kmersList.push_back(extractMinimizers(genome, k, k)); // Usar k como ventana para k-mers
+        kmersList.push_back(extractMinimizers(genome, k, k, kmerPositions)); // Usar k como ventana para k-mers
     }
 
+    // Densidad: fraccion de posiciones elegidas como minimizador, comparada con
+    // la esperada para un orden aleatorio
+    double density = kmerPositions > 0 ? static_cast<double>(minimizerPositions) / kmerPositions : 0.0;
+    double expected = s == 0 ? 2.0 / (w - k + 2) : (kind == ClosedSyncmer ? 2.0 : 1.0) / (k - s + 1);
+    cout << (s == 0 ? "Densidad de minimizadores: " : "Densidad de syncmers: ") << density
+         << " (orden aleatorio: " << expected << ")" << endl;
+
+    // Indice invertido de los minimizadores de todos los genomas: una pasada
+    // por los minimizadores de un genoma da cuantos comparte con cada uno de
+    // los demas
+    MinimizerIndex index;
+    index.build(minimizersList);
+    vector<uint32_t> shared;
+
     // Computar Jaccard y errores relativos
     vector<double> trueJaccardValues;
     vector<double> estimatedJaccardValues;
@@ -143,9 +171,11 @@ int main() {
     size_t pairCount = 0;
 
     for (size_t i = 0; i < minimizersList.size(); ++i) {
+        index.countShared(minimizersList[i], shared);
         for (size_t j = i + 1; j < minimizersList.size(); ++j) {
             double trueSimilarity = computeTrueJaccardSimilarity(kmersList[i], kmersList[j]);
-            double estimatedSimilarity = computeJaccardSimilarity(minimizersList[i], minimizersList[j]);
+            uint64_t unionSize = index.minimizerCount(i) + index.minimizerCount(j) - shared[j];
+            double estimatedSimilarity = static_cast<double>(shared[j]) / unionSize;
             trueJaccardValues.push_back(trueSimilarity);
             estimatedJaccardValues.push_back(estimatedSimilarity);
             if (trueSimilarity != 0) {
@@ -156,6 +186,23 @@ int main() {
             double absoluteError = fabs(trueSimilarity - estimatedSimilarity);
             totalAbsoluteError += absoluteError;
             cout << "Estimacion de similitud de Jaccard entre genoma " << i << " y genoma " << j << ": " << estimatedSimilarity << endl;
+
+            // Contencion |A n B| / |A| con A el genoma con menos minimizadores,
+            // corregida a k-mers como C_m^(k / L) (los syncmers no se corrigen)
+            size_t small = minimizersList[i].size() <= minimizersList[j].size() ? i : j;
+            size_t large = small == i ? j : i;
+            double sampledContainment = index.minimizerCount(small) > 0
+                                            ? static_cast<double>(shared[j]) / index.minimizerCount(small)
+                                            : 0.0;
+            double estimatedContainment =
+                s == 0 ? kmerContainmentFromSampled(sampledContainment, k, minimizerContextLength(k, w))
+                       : sampledContainment;
+            double trueContainment = kmersList[small].empty()
+                                         ? 0.0
+                                         : static_cast<double>(intersectionSize(kmersList[small], kmersList[large])) /
+                                               kmersList[small].size();
+            cout << "Estimacion de contencion del genoma " << small << " en el genoma " << large << ": " << estimatedContainment
+                 << " (muestreada: " << sampledContainment << ", real: " << trueContainment << ")" << endl;
         }
     }
 
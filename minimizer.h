@@ -0,0 +1,193 @@
+#ifndef MINIMIZER_H
+#define MINIMIZER_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "hashpolicy.h"
+#include "kmer.h"
+#include "kmerhash.h"
+
+// Minimizador elegido: k-mer codificado a 2 bits por base (la primera base en
+// los bits mas altos) y posicion de su primera base dentro del registro
+struct Minimizer {
+    uint64_t kmer;
+    uint64_t position;
+};
+
+// Ordenes para elegir el minimizador. Cada orden es una clase con
+//
+//   static uint64_t order(uint64_t code);  // menor = preferido
+//
+// El orden lexicografico favorece a los k-mers con muchas A (AAAA... es
+// siempre el minimo), asi que en regiones de baja complejidad se repite el
+// mismo minimizador y en el resto la densidad sube por encima de la de un
+// orden aleatorio, 2 / (w - k + 2). Un orden por hash se acerca a esa densidad.
+struct LexicographicOrder {
+    static uint64_t order(uint64_t code) { return code; }
+};
+
+// Orden aleatorio con kmerHash64: biyectivo, asi que no hay empates entre
+// k-mers distintos
+struct KmerHashOrder {
+    static uint64_t order(uint64_t code) { return kmerHash64(code, 0x2545f4914f6cdd1dULL); }
+};
+
+// Orden con el hash de k-mers de una politica de hashpolicy.h (SpookyHash,
+// CityHash, MurmurHash...); con 32 bits los empates los gana el de la izquierda
+template <typename HashPolicy>
+struct HashPolicyOrder {
+    static uint64_t order(uint64_t code) { return HashPolicy::hashKmer(code); }
+};
+
+// Buscador de minimizadores en O(n) para ventanas de `w` bases (w - k + 1
+// k-mers, k <= 32). Los k-mers se codifican con un codigo rodante como en
+// KmerEncoder y los candidatos se guardan en una cola doble monotona: cada
+// k-mer nuevo saca del final a los que tienen un Order::order mayor (nunca mas
+// podran ser minimos) y el frente es siempre el minimo de la ventana, asi que
+// cada k-mer entra y sale una sola vez. A igual orden gana el de mas a la
+// izquierda. Las ventanas no cruzan bases ambiguas.
+template <typename Order>
+class BasicMinimizerFinder {
+private:
+    struct Candidate {
+        uint64_t order;
+        uint64_t kmer;
+        uint64_t position;
+    };
+
+    int k;
+    uint64_t mask;
+    int topShift;                   // 2k - 2: donde entra la base en el reverso
+    bool canonical;
+    size_t windowKmers;             // w - k + 1
+    size_t ringMask;                // Capacidad de la cola (potencia de 2) - 1
+    std::vector<Candidate> queue;   // Cola doble circular, al menos windowKmers
+    size_t head, count;
+    uint64_t code, reverse;
+    int valid;                      // Bases validas consecutivas
+    size_t filled;                  // k-mers validos consecutivos (acotado)
+    uint64_t position;              // Posicion de la proxima base en el registro
+    uint64_t lastPosition;          // Posicion del ultimo minimizador entregado
+
+    Candidate &at(size_t i) { return queue[(head + i) & ringMask]; }
+
+    static size_t ringCapacity(size_t minimum) {
+        size_t capacity = 1;
+        while (capacity < minimum) capacity <<= 1;
+        return capacity;
+    }
+
+public:
+    // Con `canonical` cada k-mer se reemplaza por el menor entre el y su
+    // reverso complementario antes de ordenarlo, asi ambas hebras eligen los
+    // mismos minimizadores
+    BasicMinimizerFinder(int k, int w, bool canonical = false)
+        : k(k), mask(k == 32 ? ~uint64_t(0) : (uint64_t(1) << (2 * k)) - 1), topShift(2 * k - 2),
+          canonical(canonical), windowKmers(static_cast<size_t>(w - k + 1)),
+          ringMask(ringCapacity(windowKmers) - 1), queue(ringMask + 1) {
+        reset();
+    }
+
+    // Olvidar las bases anteriores (inicio de un nuevo registro)
+    void reset() {
+        head = count = 0;
+        code = reverse = 0;
+        valid = 0;
+        filled = 0;
+        position = 0;
+        lastPosition = ~uint64_t(0);
+    }
+
+    // Procesar una base (codigo de baseCode, mayor que 3 si es ambigua)
+    // llamando sink(minimizador) si cambia el minimizador de la ventana
+    template <typename Sink>
+    void push(uint64_t base, Sink &sink) {
+        uint64_t current = position++;
+        if (base > 3) {
+            valid = 0;
+            filled = 0;
+            count = 0;
+            return;
+        }
+        code = ((code << 2) | base) & mask;
+        reverse = (reverse >> 2) | ((3 - base) << topShift);
+        valid += valid < k;
+        if (valid < k) return;
+
+        // Sacar del frente el que queda fuera de la ventana (antes de
+        // agregar, para que la cola nunca tenga mas de windowKmers)
+        uint64_t start = current + 1 - k;
+        if (count > 0 && at(0).position + windowKmers <= start) {
+            head = (head + 1) & ringMask;
+            --count;
+        }
+
+        // Nuevo k-mer: sacar del final los que ya no pueden ser minimos
+        uint64_t kmer = canonical && reverse < code ? reverse : code;
+        Candidate candidate = { Order::order(kmer), kmer, start };
+        while (count > 0 && at(count - 1).order > candidate.order) --count;
+        at(count++) = candidate;
+
+        filled += filled < windowKmers;
+        if (filled == windowKmers && at(0).position != lastPosition) {
+            lastPosition = at(0).position;
+            Minimizer minimizer = { at(0).kmer, at(0).position };
+            sink(minimizer);
+        }
+    }
+
+    // Procesar un tramo en ASCII
+    template <typename Sink>
+    void feed(const char *data, size_t length, Sink &sink) {
+        const unsigned char *bases = reinterpret_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < length; ++i) {
+            push(baseCode[bases[i]], sink);
+        }
+    }
+
+    // Cada minimizador se entrega apenas se elige, no queda nada pendiente
+    template <typename Sink>
+    void finish(Sink &) {}
+};
+
+// Orden elegido al compilar, p.ej. -DMINIMIZER_ORDER=LexicographicOrder
+#ifndef MINIMIZER_ORDER
+#define MINIMIZER_ORDER KmerHashOrder
+#endif
+
+typedef BasicMinimizerFinder<MINIMIZER_ORDER> MinimizerFinder;
+
+// Jaccard de los k-mers a partir del Jaccard J_m entre los k-mers muestreados
+// (minimizadores o syncmers) de dos genomas de tamaño parecido.
+//
+// Con mutaciones puntuales a tasa d, un k-mer se comparte si sus k bases se
+// conservan, con probabilidad (1 - d)^k, y J = t / (2 - t) con t esa fraccion.
+// Un k-mer muestreado se comparte si ademas se conserva el contexto que decide
+// si se elige: en total `contextLength` = L bases. Entonces la fraccion
+// compartida en el espacio muestreado es t_m = 2 J_m / (1 + J_m) = (1 - d)^L,
+// y t = t_m^(k / L). Para syncmers L = k (la decision depende solo del k-mer)
+// y no hay correccion.
+inline double kmerJaccardFromSampled(double sampledJaccard, int k, double contextLength) {
+    if (sampledJaccard <= 0.0) return 0.0;
+    double sampledShared = 2.0 * sampledJaccard / (1.0 + sampledJaccard);
+    double shared = std::pow(sampledShared, k / contextLength);
+    return shared / (2.0 - shared);
+}
+
+// Contencion de los k-mers a partir de la contencion C_m de los k-mers
+// muestreados de A en los de B: con el mismo modelo, C_m = (1 - d)^L y la
+// fraccion de k-mers de A presentes en B es C_m^(k / L)
+inline double kmerContainmentFromSampled(double sampledContainment, int k, double contextLength) {
+    if (sampledContainment <= 0.0) return 0.0;
+    return std::pow(sampledContainment, k / contextLength);
+}
+
+// Largo de contexto efectivo de un minimizador con ventanas de w bases y un
+// orden aleatorio. La ventana completa es de 2w - k bases, pero un cambio solo
+// importa si crea un k-mer de menor orden; en simulaciones (k = 16 y 20,
+// w - k de 5 a 20, d hasta 6%) L queda cerca de k + (w - k) / 5.
+inline double minimizerContextLength(int k, int w) { return k + (w - k) / 5.0; }
+
+#endif
@@ -0,0 +1,41 @@
+#include <algorithm>
+#include <utility>
+#include "minimizerindex.h"
+
+void MinimizerIndex::build(const std::vector<std::vector<uint64_t> > &minimizers) {
+    counts.resize(minimizers.size());
+    std::vector<std::pair<uint64_t, uint32_t> > entries;
+    for (size_t g = 0; g < minimizers.size(); ++g) {
+        counts[g] = minimizers[g].size();
+        for (uint64_t minimizer : minimizers[g]) {
+            entries.push_back(std::make_pair(minimizer, static_cast<uint32_t>(g)));
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+
+    keys.clear();
+    offsets.clear();
+    genomes.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i == 0 || entries[i].first != entries[i - 1].first) {
+            keys.push_back(entries[i].first);
+            offsets.push_back(static_cast<uint32_t>(i));
+        }
+        genomes[i] = entries[i].second;
+    }
+    offsets.push_back(static_cast<uint32_t>(entries.size()));
+}
+
+void MinimizerIndex::countShared(const std::vector<uint64_t> &query, std::vector<uint32_t> &shared) const {
+    shared.assign(counts.size(), 0);
+    std::vector<uint64_t>::const_iterator from = keys.begin();
+    for (uint64_t minimizer : query) {
+        from = std::lower_bound(from, keys.end(), minimizer);
+        if (from == keys.end()) break;
+        if (*from != minimizer) continue;
+        size_t key = from - keys.begin();
+        for (uint32_t i = offsets[key]; i < offsets[key + 1]; ++i) {
+            ++shared[genomes[i]];
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef MINIMIZERINDEX_H
+#define MINIMIZERINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Indice invertido de minimizadores (o de cualquier k-mer muestreado) de una
+// coleccion de genomas de referencia: cada minimizador distinto apunta a la
+// lista de genomas que lo contienen. Las claves se guardan ordenadas y las
+// listas una tras otra en un solo arreglo (formato CSR: la lista de keys[i]
+// es genomes[offsets[i], offsets[i + 1])), con 8 bytes por clave mas 4 por
+// par (clave, genoma) y sin nodos ni punteros.
+//
+// Una consulta recorre sus propios minimizadores una vez y suma, para cada
+// referencia, cuantos comparte; con eso sale el Jaccard contra todas las
+// referencias sin intersectar la consulta con cada una por separado.
+class MinimizerIndex {
+private:
+    std::vector<uint64_t> keys;      // Minimizadores distintos, ordenados
+    std::vector<uint32_t> offsets;   // keys.size() + 1 inicios de lista
+    std::vector<uint32_t> genomes;   // Listas de genomas, en orden creciente
+    std::vector<uint64_t> counts;    // Minimizadores distintos de cada genoma
+
+public:
+    // `minimizers[g]` son los minimizadores del genoma g, sin repetir
+    void build(const std::vector<std::vector<uint64_t> > &minimizers);
+
+    size_t size() const { return counts.size(); }
+
+    uint64_t minimizerCount(size_t genome) const { return counts[genome]; }
+
+    // Dejar en shared[g] cuantos minimizadores de la consulta estan en el
+    // genoma g. `query` debe estar ordenado y sin repetir: asi cada busqueda
+    // continua desde la anterior en vez de partir del comienzo.
+    void countShared(const std::vector<uint64_t> &query, std::vector<uint32_t> &shared) const;
+};
+
+#endif
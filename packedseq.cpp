@@ -0,0 +1,27 @@
+#include "kmer.h"
+#include "packedseq.h"
+
+void PackedSequence::append(const char *data, size_t count) {
+    words.resize((length + count + 31) >> 5, 0);
+
+    for (size_t i = 0; i < count; ++i, ++length) {
+        uint64_t code = baseCode[static_cast<unsigned char>(data[i])];
+        if (code > 3) {
+            // Extender el tramo ambiguo anterior si es contiguo
+            if (!ambiguous.empty() && ambiguous.back().start + ambiguous.back().length == length) {
+                ++ambiguous.back().length;
+            } else {
+                AmbiguousRun run = { length, 1 };
+                ambiguous.push_back(run);
+            }
+            code = 0;
+        }
+        words[length >> 5] |= code << (62 - 2 * (length & 31));
+    }
+}
+
+void PackedSequence::startRecord() {
+    if (length > 0 && (breaks.empty() || breaks.back() != length)) {
+        breaks.push_back(length);
+    }
+}
@@ -0,0 +1,137 @@
+#ifndef PACKEDSEQ_H
+#define PACKEDSEQ_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "kmer128.h"
+
+// Tramo de bases ambiguas (N u otro codigo IUPAC) dentro de la secuencia
+struct AmbiguousRun {
+    uint64_t start;
+    uint64_t length;
+};
+
+// Secuencia de ADN empaquetada a 2 bits por base (4 bases por byte, 32 por
+// palabra de 64 bits, la primera base en los bits mas altos). Las bases que no
+// son A/C/G/T se guardan como A y se anotan en una tabla aparte de tramos
+// ambiguos; las mayusculas y minusculas se tratan igual. Tambien se anotan los
+// limites entre registros (p.ej. lecturas de un FASTQ) para que ningun k-mer
+// los cruce.
+class PackedSequence {
+private:
+    std::vector<uint64_t> words;
+    uint64_t length;
+    std::vector<AmbiguousRun> ambiguous;
+    std::vector<uint64_t> breaks;  // Posiciones donde empieza un nuevo registro
+
+public:
+    PackedSequence() : length(0) {}
+
+    // Agregar bases en ASCII al final de la secuencia
+    void append(const char *data, size_t count);
+
+    // Marcar el inicio de un nuevo registro en la posicion actual
+    void startRecord();
+
+    uint64_t size() const { return length; }
+
+    // Recorre los k-mers (k <= 32) sin bases ambiguas llamando
+    // sink(codigo, posicion), donde el codigo tiene la primera base en los bits
+    // mas altos. Con `canonical` se entrega el menor entre el k-mer y su reverso
+    // complementario.
+    template <typename Sink>
+    void forEachKmer(int k, Sink sink, bool canonical = false) const {
+        const uint64_t mask = k == 32 ? ~uint64_t(0) : (uint64_t(1) << (2 * k)) - 1;
+        const int topShift = 2 * k - 2;
+        uint64_t code = 0;
+        uint64_t reverse = 0;
+        int valid = 0;  // Bases validas consecutivas en la ventana
+
+        forEachBase(
+            [&](uint64_t base, uint64_t pos) {
+                code = ((code << 2) | base) & mask;
+                reverse = (reverse >> 2) | ((3 - base) << topShift);
+                valid += valid < k;
+                if (valid == k) {
+                    sink(canonical && reverse < code ? reverse : code, pos + 1 - k);
+                }
+            },
+            [&]() { valid = 0; });
+    }
+
+    // Igual que forEachKmer pero para k <= 64, con k-mers de dos palabras
+    template <typename Sink>
+    void forEachKmer128(int k, Sink sink, bool canonical = false) const {
+        Kmer128Roller roller(k);
+        int valid = 0;
+
+        forEachBase(
+            [&](uint64_t base, uint64_t pos) {
+                roller.push(base);
+                valid += valid < k;
+                if (valid == k) {
+                    sink(canonical ? roller.canonicalKmer() : roller.forwardKmer(), pos + 1 - k);
+                }
+            },
+            [&]() { valid = 0; });
+    }
+
+    // Recorre los k-mers elegidos por un muestreador (MinimizerFinder o
+    // SyncmerFinder) llamando sink(k-mer elegido). Cada corte de registro o
+    // tramo ambiguo se le entrega como una base ambigua.
+    template <typename Sampler, typename Sink>
+    void forEachSampledKmer(Sampler &sampler, Sink sink) const {
+        sampler.reset();
+        forEachBase([&](uint64_t base, uint64_t) { sampler.push(base, sink); },
+                    [&]() { sampler.push(4, sink); });
+        sampler.finish(sink);
+    }
+
+private:
+    // Recorre las bases llamando onBase(codigo, posicion) por cada base no
+    // ambigua y onBreak() al empezar un registro o un tramo ambiguo. Entre dos
+    // obstaculos las bases se leen sin revisiones, cargando una palabra de 64
+    // bits cada 32 bases, y cada tramo ambiguo se salta de una vez usando la
+    // tabla.
+    template <typename OnBase, typename OnBreak>
+    void forEachBase(OnBase onBase, OnBreak onBreak) const {
+        size_t runIndex = 0;
+        size_t breakIndex = 0;
+        uint64_t pos = 0;
+
+        while (pos < length) {
+            uint64_t stop = nextObstacle(runIndex, breakIndex);
+            if (pos == stop) {
+                while (breakIndex < breaks.size() && breaks[breakIndex] == pos) {
+                    onBreak();
+                    ++breakIndex;
+                }
+                if (runIndex < ambiguous.size() && ambiguous[runIndex].start == pos) {
+                    onBreak();
+                    pos += ambiguous[runIndex].length;
+                    ++runIndex;
+                    // Los cortes dentro del tramo no separan ninguna base
+                    while (breakIndex < breaks.size() && breaks[breakIndex] < pos) ++breakIndex;
+                }
+                continue;
+            }
+
+            uint64_t word = words[pos >> 5] << (2 * (pos & 31));
+            for (; pos < stop; ++pos, word <<= 2) {
+                if ((pos & 31) == 0) word = words[pos >> 5];
+                onBase(word >> 62, pos);
+            }
+        }
+    }
+
+    // Siguiente posicion donde empieza un tramo ambiguo o un registro
+    uint64_t nextObstacle(size_t runIndex, size_t breakIndex) const {
+        uint64_t next = length;
+        if (runIndex < ambiguous.size() && ambiguous[runIndex].start < next) next = ambiguous[runIndex].start;
+        if (breakIndex < breaks.size() && breaks[breakIndex] < next) next = breaks[breakIndex];
+        return next;
+    }
+};
+
+#endif
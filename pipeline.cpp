@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include "kmer.h"
+#include "kmer128.h"
+#include "pipeline.h"
+#include "seqreader.h"
+#include "spscqueue.h"
+
+// Tamaño de los lotes y cantidad de lotes en circulacion por etapa
+static const size_t batchBases = 1 << 16;
+static const size_t batchHashes = 1 << 14;
+static const size_t queueDepth = 8;
+
+enum BatchKind { SequenceData, EndOfFile, EndOfInput };
+
+// Lote de bases de un mismo archivo. Puede tener varios registros (p.ej.
+// lecturas FASTQ) o parte de uno; `recordStarts` tiene las posiciones donde
+// empieza cada registro, en las que se reinicia el codificador de k-mers.
+struct SequenceBatch {
+    BatchKind kind;
+    size_t file;
+    bool ok;  // Solo en EndOfFile: el archivo se leyo sin errores
+    std::vector<char> bases;
+    size_t length;
+    std::vector<size_t> recordStarts;
+
+    SequenceBatch() : kind(SequenceData), file(0), ok(true), length(0) {}
+};
+
+// Lote de hashes de k-mers de un mismo archivo
+struct HashBatch {
+    BatchKind kind;
+    size_t file;
+    bool ok;
+    std::vector<uint32_t> hashes;
+    size_t count;
+
+    HashBatch() : kind(SequenceData), file(0), ok(true), count(0) {}
+};
+
+// Par de colas de una conexion entre etapas: por `full` viajan los lotes con
+// datos y por `empty` vuelven los lotes ya procesados para reutilizarlos
+template <typename Batch>
+struct BatchChannel {
+    SpscQueue<Batch> full;
+    SpscQueue<Batch> empty;
+
+    BatchChannel() : full(queueDepth), empty(queueDepth) {}
+};
+
+// Etapa 1: handler de readSequenceFile que copia la secuencia a lotes
+class BatchWriter {
+private:
+    BatchChannel<SequenceBatch> &channel;
+    SequenceBatch batch;
+    size_t file;
+
+    // Tomar un lote libre; espera si la etapa siguiente va atrasada
+    void acquire() {
+        channel.empty.pop(batch);
+        batch.kind = SequenceData;
+        batch.file = file;
+        batch.ok = true;
+        batch.length = 0;
+        batch.recordStarts.clear();
+    }
+
+    void flush() {
+        if (batch.length == 0 && batch.recordStarts.empty()) return;
+        channel.full.push(batch);
+        acquire();
+    }
+
+public:
+    explicit BatchWriter(BatchChannel<SequenceBatch> &channel) : channel(channel), file(0) {
+        acquire();
+    }
+
+    // El lote solo se envia cuando se llena, asi los registros cortos viajan
+    // juntos
+    void beginRecord(const std::string &) {
+        batch.recordStarts.push_back(batch.length);
+    }
+
+    void sequence(const char *data, size_t length) {
+        while (length > 0) {
+            size_t n = std::min(length, batchBases - batch.length);
+            std::memcpy(&batch.bases[batch.length], data, n);
+            batch.length += n;
+            data += n;
+            length -= n;
+            if (batch.length == batchBases) flush();
+        }
+    }
+
+    bool endRecord() { return true; }
+
+    void startFile(size_t index) {
+        file = index;
+        batch.file = index;
+    }
+
+    void endFile(bool ok) {
+        flush();
+        batch.kind = EndOfFile;
+        batch.ok = ok;
+        channel.full.push(batch);
+        acquire();
+    }
+
+    void endInput() {
+        batch.kind = EndOfInput;
+        channel.full.push(batch);
+    }
+};
+
+static void readStage(const std::vector<std::string> &filenames, BatchChannel<SequenceBatch> &output) {
+    BatchWriter writer(output);
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        writer.startFile(i);
+        writer.endFile(readSequenceFile(filenames[i], writer));
+    }
+    writer.endInput();
+}
+
+// Etapa 2: recorre los k-mers de cada lote y calcula sus hashes
+class HashWriter {
+private:
+    BatchChannel<HashBatch> &channel;
+    HashBatch batch;
+    size_t file;
+
+    void acquire() {
+        channel.empty.pop(batch);
+        batch.kind = SequenceData;
+        batch.file = file;
+        batch.ok = true;
+        batch.count = 0;
+    }
+
+public:
+    explicit HashWriter(BatchChannel<HashBatch> &channel) : channel(channel), file(0) {
+        acquire();
+    }
+
+    void setFile(size_t index) {
+        file = index;
+        batch.file = index;
+    }
+
+    // Llamado por KmerEncoder (o Kmer128Encoder) con cada k-mer
+    template <typename Kmer>
+    void operator()(const Kmer &kmer) {
+        batch.hashes[batch.count++] = HyperLogLog::hashKmer(kmer);
+        if (batch.count == batchHashes) {
+            channel.full.push(batch);
+            acquire();
+        }
+    }
+
+    // Reenviar un lote de control despues de los hashes pendientes
+    void forward(BatchKind kind, size_t index, bool ok) {
+        if (batch.count > 0) {
+            channel.full.push(batch);
+            acquire();
+        }
+        batch.kind = kind;
+        batch.file = index;
+        batch.ok = ok;
+        channel.full.push(batch);
+        if (kind != EndOfInput) acquire();
+    }
+};
+
+template <typename Encoder>
+static void hashStage(Encoder encoder, BatchChannel<SequenceBatch> &input, BatchChannel<HashBatch> &output) {
+    HashWriter writer(output);
+    SequenceBatch batch;
+
+    for (;;) {
+        input.full.pop(batch);
+        BatchKind kind = batch.kind;
+        if (kind == SequenceData) {
+            writer.setFile(batch.file);
+            size_t position = 0;
+            for (size_t start : batch.recordStarts) {
+                encoder.feed(batch.bases.data() + position, start - position, writer);
+                encoder.reset();
+                position = start;
+            }
+            encoder.feed(batch.bases.data() + position, batch.length - position, writer);
+        } else {
+            encoder.reset();
+            writer.forward(kind, batch.file, batch.ok);
+        }
+        input.empty.push(batch);
+        if (kind == EndOfInput) return;
+    }
+}
+
+// Etapa 3: actualiza los registros del sketch de cada archivo
+static void sketchStage(BatchChannel<HashBatch> &input, std::vector<HyperLogLog> &sketches,
+                        std::vector<char> &ok) {
+    HashBatch batch;
+    for (;;) {
+        input.full.pop(batch);
+        BatchKind kind = batch.kind;
+        if (kind == SequenceData) {
+            HyperLogLog &hll = sketches[batch.file];
+            for (size_t i = 0; i < batch.count; ++i) {
+                hll.addHash(batch.hashes[i]);
+            }
+        } else if (kind == EndOfFile) {
+            ok[batch.file] = batch.ok;
+        }
+        input.empty.push(batch);
+        if (kind == EndOfInput) return;
+    }
+}
+
+void sketchFilesPipelined(const std::vector<std::string> &filenames, int k,
+                          std::vector<HyperLogLog> &sketches, std::vector<char> &ok,
+                          bool canonical) {
+    BatchChannel<SequenceBatch> sequences;
+    BatchChannel<HashBatch> hashes;
+
+    // Llenar las colas de retorno con los lotes que circularan
+    for (size_t i = 0; i < queueDepth; ++i) {
+        SequenceBatch sequenceBatch;
+        sequenceBatch.bases.resize(batchBases);
+        sequences.empty.push(sequenceBatch);
+
+        HashBatch hashBatch;
+        hashBatch.hashes.resize(batchHashes);
+        hashes.empty.push(hashBatch);
+    }
+
+    std::thread reader(readStage, std::cref(filenames), std::ref(sequences));
+    std::thread hasher;
+    if (k > 32) {
+        hasher = std::thread(hashStage<Kmer128Encoder>, Kmer128Encoder(k, canonical),
+                             std::ref(sequences), std::ref(hashes));
+    } else {
+        hasher = std::thread(hashStage<KmerEncoder>, KmerEncoder(k, canonical),
+                             std::ref(sequences), std::ref(hashes));
+    }
+    sketchStage(hashes, sketches, ok);
+
+    reader.join();
+    hasher.join();
+}
@@ -0,0 +1,21 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <string>
+#include <vector>
+#include "hyperloglog.h"
+
+// Construye un sketch por archivo con un pipeline de tres hilos:
+//
+//   lectura (FASTA/FASTQ) -> k-mers y hash -> registros del HyperLogLog
+//
+// Las etapas se comunican por colas SpscQueue de lotes de tamaño fijo que se
+// reciclan por colas de retorno, asi la memoria queda acotada por la
+// profundidad de las colas y no por el tamaño de los genomas, y la lectura del
+// archivo N+1 se solapa con el sketch del archivo N.
+// `ok[i]` queda en false si el archivo i no se pudo leer. Se admite k <= 64.
+void sketchFilesPipelined(const std::vector<std::string> &filenames, int k,
+                          std::vector<HyperLogLog> &sketches, std::vector<char> &ok,
+                          bool canonical = false);
+
+#endif
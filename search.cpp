@@ -0,0 +1,58 @@
+#include "search.h"
+
+// Referencias por tarea: suficientes para que el costo de encolar sea
+// despreciable frente a las comparaciones (2^p registros cada una)
+static const size_t searchBlock = 64;
+
+SketchSearcher::SketchSearcher(const SketchDatabase &database, ThreadPool &pool)
+    : database(database), cardinalities(database.sketches.size()) {
+    for (size_t start = 0; start < cardinalities.size(); start += searchBlock) {
+        size_t end = std::min(start + searchBlock, cardinalities.size());
+        pool.submit([this, start, end] {
+            for (size_t i = start; i < end; ++i) {
+                cardinalities[i] = this->database.sketches[i].estimate();
+            }
+        });
+    }
+    pool.wait();
+}
+
+std::vector<SearchHit> SketchSearcher::topK(const HyperLogLog &query, size_t count, ThreadPool &pool) const {
+    // Nunca hay mas resultados que referencias, ni mas de un bloque por
+    // monticulo parcial: asi un `count` enorme no reserva memoria de mas
+    count = std::min(count, size());
+    double queryCardinality = query.estimate();
+    size_t blocks = (size() + searchBlock - 1) / searchBlock;
+    std::vector<std::vector<SearchHit> > partial(blocks);
+
+    for (size_t b = 0; b < blocks; ++b) {
+        pool.submit([this, &query, &partial, queryCardinality, count, b] {
+            size_t start = b * searchBlock;
+            size_t end = std::min(start + searchBlock, size());
+            BoundedHeap heap(std::min(count, end - start));
+            for (size_t i = start; i < end; ++i) {
+                SearchHit hit = { i, similarity(query, queryCardinality, i) };
+                heap.offer(hit);
+            }
+            partial[b] = heap.take();
+        });
+    }
+    pool.wait();
+
+    BoundedHeap best(count);
+    for (const auto &hits : partial) {
+        for (const auto &hit : hits) best.offer(hit);
+    }
+    return best.take();
+}
+
+std::vector<SearchHit> SketchSearcher::rank(const HyperLogLog &query, const std::vector<size_t> &candidates,
+                                            double minSimilarity, size_t count) const {
+    double queryCardinality = query.estimate();
+    BoundedHeap best(std::min(count, candidates.size()));
+    for (size_t reference : candidates) {
+        SearchHit hit = { reference, similarity(query, queryCardinality, reference) };
+        if (hit.similarity >= minSimilarity) best.offer(hit);
+    }
+    return best.take();
+}
@@ -0,0 +1,100 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "hyperloglog.h"
+#include "sketchdb.h"
+#include "threadpool.h"
+
+// Jaccard a partir de las cardinalidades estimadas de A, B y su union,
+// asegurando que no sea negativo
+inline double jaccardFromEstimates(double estimateA, double estimateB, double estimateUnion) {
+    return std::max(0.0, (estimateA + estimateB - estimateUnion) / estimateUnion);
+}
+
+// Referencia encontrada por una busqueda
+struct SearchHit {
+    size_t reference;   // Indice en la SketchDatabase
+    double similarity;  // Jaccard estimado
+};
+
+// Mayor similitud primero; a igual similitud, el menor indice
+inline bool betterHit(const SearchHit &a, const SearchHit &b) {
+    return a.similarity > b.similarity || (a.similarity == b.similarity && a.reference < b.reference);
+}
+
+// Monticulo que conserva los `capacity` mejores resultados; la raiz es el peor
+// de ellos, asi que cada candidato se descarta con una sola comparacion
+class BoundedHeap {
+private:
+    std::vector<SearchHit> hits;
+    size_t capacity;
+
+public:
+    explicit BoundedHeap(size_t capacity) : capacity(capacity) { hits.reserve(capacity); }
+
+    bool full() const { return hits.size() == capacity; }
+
+    // El peor resultado guardado (solo si no esta vacio)
+    const SearchHit &worst() const { return hits.front(); }
+
+    void offer(const SearchHit &hit) {
+        if (capacity == 0) return;
+        if (hits.size() < capacity) {
+            hits.push_back(hit);
+            std::push_heap(hits.begin(), hits.end(), betterHit);
+        } else if (betterHit(hit, hits.front())) {
+            std::pop_heap(hits.begin(), hits.end(), betterHit);
+            hits.back() = hit;
+            std::push_heap(hits.begin(), hits.end(), betterHit);
+        }
+    }
+
+    // Los resultados del mejor al peor (deja el monticulo vacio)
+    std::vector<SearchHit> take() {
+        std::sort_heap(hits.begin(), hits.end(), betterHit);
+        std::vector<SearchHit> sorted;
+        sorted.swap(hits);
+        return sorted;
+    }
+};
+
+// Busqueda de las referencias mas parecidas a una consulta en una coleccion
+// de sketches. La cardinalidad de cada referencia se estima una sola vez al
+// construir el buscador; cada comparacion solo recorre los registros para
+// estimar la union, sin copiar sketches.
+class SketchSearcher {
+private:
+    const SketchDatabase &database;
+    std::vector<double> cardinalities;
+
+public:
+    SketchSearcher(const SketchDatabase &database, ThreadPool &pool);
+
+    size_t size() const { return cardinalities.size(); }
+
+    double cardinality(size_t reference) const { return cardinalities[reference]; }
+
+    const HyperLogLog &sketch(size_t reference) const { return database.sketches[reference]; }
+
+    // Jaccard estimado entre la consulta (con su cardinalidad ya calculada) y
+    // una referencia
+    double similarity(const HyperLogLog &query, double queryCardinality, size_t reference) const {
+        return jaccardFromEstimates(queryCardinality, cardinalities[reference],
+                                    query.estimateUnion(database.sketches[reference]));
+    }
+
+    // Las `count` referencias mas parecidas, de la mejor a la peor. La
+    // coleccion se recorre en bloques repartidos en `pool`; cada bloque llena
+    // su propio monticulo acotado y al final se combinan.
+    std::vector<SearchHit> topK(const HyperLogLog &query, size_t count, ThreadPool &pool) const;
+
+    // Comparar la consulta solo con `candidates` (p.ej. los de un LshIndex) y
+    // retornar las `count` mejores con similitud >= minSimilarity
+    std::vector<SearchHit> rank(const HyperLogLog &query, const std::vector<size_t> &candidates,
+                                double minSimilarity, size_t count) const;
+};
+
+#endif
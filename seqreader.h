@@ -0,0 +1,73 @@
+#ifndef SEQREADER_H
+#define SEQREADER_H
+
+#include <string>
+#include "fasta.h"
+#include "fastq.h"
+#include "gzreader.h"
+
+// Un archivo es FASTQ si su primer caracter no blanco es '@'
+inline bool looksLikeFastq(const char *data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        if (data[i] == '\n' || data[i] == '\r' || data[i] == ' ') continue;
+        return data[i] == '@';
+    }
+    return false;
+}
+
+// Entregar al analizador el bloque ya leido y los siguientes del lector gzip
+template <typename Parser>
+bool parseGzipChunks(GzipReader &reader, Parser &parser, const char *data, size_t length) {
+    if (!parser.feed(data, length)) return parser.finish();
+    while (reader.next(data, length)) {
+        if (!parser.feed(data, length)) return parser.finish();
+    }
+    return parser.finish() && !reader.hasError();
+}
+
+// Lee un archivo de secuencias FASTA o FASTQ entregando sus registros a
+// `handler` (ver FastaStreamParser). Los archivos .gz se detectan por su
+// firma y se descomprimen en un hilo aparte; los archivos de texto plano se
+// mapean en memoria y se recorren sin copiar. Retorna false si el archivo no
+// se pudo abrir, estaba corrupto o es un FASTQ mal formado o truncado.
+template <typename Handler>
+bool readSequenceFile(const std::string &filename, Handler &handler) {
+    if (GzipReader::isGzipFile(filename)) {
+        GzipReader reader(filename);
+        if (!reader.isOpen()) return false;
+
+        const char *data;
+        size_t length;
+        if (!reader.next(data, length)) return !reader.hasError();
+
+        if (looksLikeFastq(data, length)) {
+            FastqStreamParser<Handler> parser(handler);
+            return parseGzipChunks(reader, parser, data, length);
+        }
+        FastaStreamParser<Handler> parser(handler);
+        return parseGzipChunks(reader, parser, data, length);
+    }
+
+    MappedFile file(filename);
+    if (!file.isOpen()) return false;
+
+    // El archivo mapeado completo es un unico bloque para el analizador FASTQ
+    if (looksLikeFastq(file.data(), file.size())) {
+        FastqStreamParser<Handler> parser(handler);
+        parser.feed(file.data(), file.size());
+        return parser.finish();
+    }
+
+    FastaScanner scanner(file.data(), file.size());
+    FastaRecord record;
+    while (scanner.next(record)) {
+        handler.beginRecord(scanner.header(record));
+        for (const auto &segment : record.segments) {
+            handler.sequence(segment.data, segment.length);
+        }
+        if (!handler.endRecord()) break;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include "sketchdb.h"
+
+static const char databaseMagic[8] = { 'H', 'L', 'L', 'S', 'K', 'D', 'B', '2' };
+
+template <typename T>
+static void writeValue(std::ostream &out, T value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool readValue(std::istream &in, T &value) {
+    in.read(reinterpret_cast<char *>(&value), sizeof(value));
+    return static_cast<bool>(in);
+}
+
+void writeHashPolicy(std::ostream &out) {
+    const char *name = HyperLogLog::Policy::name();
+    uint32_t length = static_cast<uint32_t>(std::strlen(name));
+    writeValue<uint32_t>(out, length);
+    out.write(name, length);
+}
+
+bool readHashPolicy(std::istream &in) {
+    const char *name = HyperLogLog::Policy::name();
+    uint32_t length;
+    if (!readValue(in, length) || length != std::strlen(name)) return false;
+    std::string stored(length, '\0');
+    in.read(&stored[0], length);
+    return in && stored == name;
+}
+
+bool SketchDatabase::save(const std::string &filename) const {
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    if (!out) return false;
+
+    out.write(databaseMagic, sizeof(databaseMagic));
+    writeHashPolicy(out);
+    writeValue<int32_t>(out, k);
+    writeValue<int32_t>(out, HyperLogLog::precision());
+    writeValue<uint8_t>(out, canonical ? 1 : 0);
+    writeValue<int32_t>(out, sampling.mode);
+    writeValue<int32_t>(out, sampling.parameter);
+    writeValue<uint64_t>(out, sketches.size());
+
+    for (size_t i = 0; i < sketches.size(); ++i) {
+        writeValue<uint32_t>(out, static_cast<uint32_t>(names[i].size()));
+        out.write(names[i].data(), names[i].size());
+        if (!sketches[i].write(out)) return false;
+    }
+    return static_cast<bool>(out);
+}
+
+bool SketchDatabase::load(const std::string &filename) {
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    if (!in) return false;
+
+    char magic[sizeof(databaseMagic)];
+    int32_t storedK, storedPrecision;
+    uint8_t storedCanonical;
+    int32_t storedMode, storedParameter;
+    uint64_t count;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, databaseMagic, sizeof(magic)) != 0) return false;
+    if (!readHashPolicy(in)) return false;
+    if (!readValue(in, storedK) || !readValue(in, storedPrecision) || !readValue(in, storedCanonical) ||
+        !readValue(in, storedMode) || !readValue(in, storedParameter) || !readValue(in, count)) {
+        return false;
+    }
+    if (storedK < 1 || storedK > 64) return false;
+    if (storedPrecision != HyperLogLog::precision() || storedCanonical > 1) return false;
+    if (storedMode < KmerSampling::AllKmers || storedMode > KmerSampling::Syncmers) return false;
+
+    // Cada sketch ocupa al menos el largo del nombre y sus 2^p registros; un
+    // `count` mayor que lo que queda del archivo viene de un archivo corrupto
+    std::streampos start = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::streampos fileEnd = in.tellg();
+    in.seekg(start);
+    uint64_t remaining = static_cast<uint64_t>(fileEnd - start);
+    if (!in || count > remaining / (sizeof(uint32_t) + (uint64_t(1) << HyperLogLog::precision()))) return false;
+
+    k = storedK;
+    canonical = storedCanonical != 0;
+    sampling = KmerSampling(static_cast<KmerSampling::Mode>(storedMode), storedParameter);
+    names.assign(count, std::string());
+    sketches.assign(count, HyperLogLog());
+    for (uint64_t i = 0; i < count; ++i) {
+        uint32_t nameLength;
+        if (!readValue(in, nameLength)) return false;
+        // Igual que `count`: un largo mayor que lo que queda es un archivo corrupto
+        if (nameLength > static_cast<uint64_t>(fileEnd - in.tellg())) return false;
+        names[i].resize(nameLength);
+        in.read(&names[i][0], nameLength);
+        if (!in || !sketches[i].read(in)) return false;
+    }
+    return true;
+}
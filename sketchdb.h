@@ -0,0 +1,41 @@
+#ifndef SKETCHDB_H
+#define SKETCHDB_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "hyperloglog.h"
+#include "sketcher.h"
+
+// Coleccion de sketches guardada en disco por el comando `sketch`.
+// Formato binario: firma "HLLSKDB2", politica de hash (ver writeHashPolicy),
+// k y precision p (int32), si los k-mers son canonicos (uint8), el muestreo
+// de k-mers (modo y parametro, int32), cantidad de sketches (uint64) y luego,
+// por cada sketch, el largo del nombre (uint32), el nombre y los 2^p
+// registros de un byte.
+struct SketchDatabase {
+    int k;
+    bool canonical;         // Sketches de k-mers canonicos (-C)
+    KmerSampling sampling;  // K-mers que entraron a los sketches (-w, -s)
+    std::vector<std::string> names;
+    std::vector<HyperLogLog> sketches;
+
+    SketchDatabase() : k(0), canonical(false) {}
+
+    bool save(const std::string &filename) const;
+
+    // Retorna false si el archivo no existe, esta truncado, fue creado con
+    // otra precision o politica de hash de HyperLogLog, o trae un k fuera de
+    // 1..64 o registros mayores que 32
+    bool load(const std::string &filename);
+};
+
+// Nombre de la politica de hash del HyperLogLog (largo uint32 y bytes). Lo
+// guardan la base y sus indices: sketches de politicas distintas no se pueden
+// comparar aunque tengan la misma precision.
+void writeHashPolicy(std::ostream &out);
+
+// Retorna false si el nombre guardado no es el de la politica del programa
+bool readHashPolicy(std::istream &in);
+
+#endif
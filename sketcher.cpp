@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include "seqreader.h"
+#include "sketcher.h"
+
+bool sketchFile(const std::string &filename, int k, HyperLogLog &hll, AbundanceFilter *filter,
+                bool canonical) {
+    SketchBuilder builder(k, hll, filter, canonical);
+    return readSequenceFile(filename, builder);
+}
+
+bool sketchFile(const std::string &filename, int k, HyperLogLog &hll, const KmerSampling &sampling,
+                bool canonical) {
+    if (sampling.mode == KmerSampling::Minimizers) {
+        MinimizerFinder finder(k, sampling.parameter, canonical);
+        SampledSketchBuilder<MinimizerFinder> builder(finder, hll);
+        return readSequenceFile(filename, builder);
+    }
+    if (sampling.mode == KmerSampling::Syncmers) {
+        SyncmerFinder finder(k, sampling.parameter, ClosedSyncmer, 0, canonical);
+        SampledSketchBuilder<SyncmerFinder> builder(finder, hll);
+        return readSequenceFile(filename, builder);
+    }
+    return sketchFile(filename, k, hll, nullptr, canonical);
+}
+
+bool sketchFile(const std::string &filename, const std::vector<int> &ks,
+                const std::vector<HyperLogLog *> &sketches, bool canonical) {
+    if (ks.size() == 1 && ks[0] > 32) {
+        WideSketchBuilder builder(ks[0], *sketches[0], canonical);
+        return readSequenceFile(filename, builder);
+    }
+    MultiSketchBuilder builder(ks, sketches, canonical);
+    return readSequenceFile(filename, builder);
+}
+
+// Entregar a `builder` las bases de los bytes [from, to) de un FASTA mapeado y
+// luego hasta `overlap` bases mas, sin pasar al registro siguiente. `from` y
+// `to` pueden caer en medio de una linea; los encabezados reinician el
+// codificador y los '\r' de fin de linea se descartan.
+template <typename Builder>
+static void feedRange(const char *data, size_t size, size_t from, size_t to, size_t overlap, Builder &builder) {
+    // Inicio de la linea donde cae `from`, para saber si es un encabezado
+    size_t lineStart = from;
+    while (lineStart > 0 && data[lineStart - 1] != '\n') --lineStart;
+
+    builder.beginRecord(std::string());
+    size_t pos = from;
+    while (pos < size) {
+        const char *newline = static_cast<const char *>(std::memchr(data + pos, '\n', size - pos));
+        size_t lineEnd = newline ? static_cast<size_t>(newline - data) : size;
+        size_t contentEnd = lineEnd;
+        if (contentEnd > lineStart && data[contentEnd - 1] == '\r') --contentEnd;
+
+        if (data[lineStart] == '>') {
+            if (lineStart >= to) break;  // El traslape no entra al registro siguiente
+            if (lineStart >= from) builder.beginRecord(std::string());
+        } else {
+            // Bases propias del rango y luego las del traslape
+            if (pos < to && pos < contentEnd) {
+                size_t end = std::min(contentEnd, to);
+                builder.sequence(data + pos, end - pos);
+                pos = end;
+            }
+            if (pos >= to && pos < contentEnd) {
+                size_t length = std::min(contentEnd - pos, overlap);
+                builder.sequence(data + pos, length);
+                overlap -= length;
+            }
+            if (pos >= to && overlap == 0) break;
+        }
+
+        pos = lineStart = newline ? lineEnd + 1 : size;
+    }
+}
+
+// Llenar un sketch por cada k con los k-mers de un rango del archivo
+static void sketchRange(const char *data, size_t size, size_t from, size_t to, size_t overlap,
+                        const std::vector<int> &ks, const std::vector<HyperLogLog *> &sketches, bool canonical) {
+    if (ks.size() == 1 && ks[0] > 32) {
+        WideSketchBuilder builder(ks[0], *sketches[0], canonical);
+        feedRange(data, size, from, to, overlap, builder);
+    } else {
+        MultiSketchBuilder builder(ks, sketches, canonical);
+        feedRange(data, size, from, to, overlap, builder);
+    }
+}
+
+// Estado compartido por los trozos de un archivo; el mapeo debe seguir vivo
+// hasta que termine el ultimo trozo
+struct ChunkedSketch {
+    MappedFile file;
+    std::vector<int> ks;
+    std::vector<HyperLogLog *> sketches;
+    bool canonical;
+    std::mutex mutex;
+
+    ChunkedSketch(const std::string &filename, const std::vector<int> &ks,
+                  const std::vector<HyperLogLog *> &sketches, bool canonical)
+        : file(filename), ks(ks), sketches(sketches), canonical(canonical) {}
+
+    void merge(const std::vector<HyperLogLog> &partial) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < partial.size(); ++i) {
+            sketches[i]->merge(partial[i]);
+        }
+    }
+};
+
+// Punteros a cada sketch de un vector, en el formato de sketchRange
+static std::vector<HyperLogLog *> pointersTo(std::vector<HyperLogLog> &sketches) {
+    std::vector<HyperLogLog *> pointers;
+    for (auto &sketch : sketches) {
+        pointers.push_back(&sketch);
+    }
+    return pointers;
+}
+
+bool sketchFileChunked(const std::string &filename, const std::vector<int> &ks,
+                       const std::vector<HyperLogLog *> &sketches,
+                       ThreadPool &pool, size_t chunkBases, bool canonical) {
+    if (GzipReader::isGzipFile(filename)) {
+        return sketchFile(filename, ks, sketches, canonical);
+    }
+
+    std::shared_ptr<ChunkedSketch> shared = std::make_shared<ChunkedSketch>(filename, ks, sketches, canonical);
+    if (!shared->file.isOpen()) return false;
+    if (looksLikeFastq(shared->file.data(), shared->file.size())) {
+        return sketchFile(filename, ks, sketches, canonical);
+    }
+
+    // Los trozos son rangos de `chunkBases` bytes del archivo, sin recorrerlo
+    // antes: cada tarea ubica sus lineas y registros. Cada trozo lee ademas
+    // max(ks) - 1 bases del siguiente, asi que todo k-mer queda completo en
+    // algun trozo (los repetidos no cambian el HyperLogLog).
+    size_t overlap = *std::max_element(ks.begin(), ks.end()) - 1;
+    size_t size = shared->file.size();
+    for (size_t from = 0; from < size; from += chunkBases) {
+        size_t to = std::min(size, from + chunkBases);
+        pool.submit([shared, from, to, overlap] {
+            std::vector<HyperLogLog> partial(shared->ks.size());
+            sketchRange(shared->file.data(), shared->file.size(), from, to, overlap, shared->ks,
+                        pointersTo(partial), shared->canonical);
+            shared->merge(partial);
+        });
+    }
+    return true;
+}
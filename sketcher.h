@@ -0,0 +1,164 @@
+#ifndef SKETCHER_H
+#define SKETCHER_H
+
+#include <string>
+#include <vector>
+#include "abundance.h"
+#include "hyperloglog.h"
+#include "kmer.h"
+#include "kmer128.h"
+#include "minimizer.h"
+#include "syncmer.h"
+#include "threadpool.h"
+
+// Handler para readSequenceFile que inserta todos los k-mers de una entrada
+// en un solo HyperLogLog, sin guardar la secuencia ni el conjunto de k-mers.
+// Los k-mers no cruzan de un registro a otro ni incluyen bases ambiguas; con
+// `canonical` cada k-mer se cuenta en su forma canonica (el menor entre el y su
+// reverso complementario), de modo que ambas hebras dan el mismo sketch.
+class SketchBuilder {
+private:
+    KmerEncoder encoder;
+    HyperLogLog &hll;
+    AbundanceFilter *filter;  // nullptr si no se filtra por abundancia
+    size_t bases;
+
+public:
+    SketchBuilder(int k, HyperLogLog &hll, AbundanceFilter *filter = nullptr, bool canonical = false)
+        : encoder(k, canonical), hll(hll), filter(filter), bases(0) {}
+
+    void beginRecord(const std::string &) { encoder.reset(); }
+
+    void sequence(const char *data, size_t length) {
+        bases += length;
+        encoder.feed(data, length, *this);
+    }
+
+    // Llamado por KmerEncoder con cada k-mer
+    void operator()(uint64_t code) {
+        if (filter && !filter->add(code)) return;
+        hll.addKmer(code);
+    }
+
+    bool endRecord() { return true; }
+
+    size_t totalBases() const { return bases; }
+};
+
+// Handler que llena un HyperLogLog por cada k de `ks` en una sola pasada
+class MultiSketchBuilder {
+private:
+    MultiKmerEncoder encoder;
+    std::vector<HyperLogLog *> sketches;
+
+public:
+    MultiSketchBuilder(const std::vector<int> &ks, const std::vector<HyperLogLog *> &sketches,
+                       bool canonical = false)
+        : encoder(ks, canonical), sketches(sketches) {}
+
+    void beginRecord(const std::string &) { encoder.reset(); }
+
+    void sequence(const char *data, size_t length) { encoder.feed(data, length, *this); }
+
+    // Llamado por MultiKmerEncoder con el k-mer de largo ks[index]
+    void operator()(size_t index, uint64_t code) { sketches[index]->addKmer(code); }
+
+    bool endRecord() { return true; }
+};
+
+// Handler para k de 33 a 64: los k-mers ocupan dos palabras y se insertan
+// con HyperLogLog::addKmer(const Kmer128 &)
+class WideSketchBuilder {
+private:
+    Kmer128Encoder encoder;
+    HyperLogLog &hll;
+
+public:
+    WideSketchBuilder(int k, HyperLogLog &hll, bool canonical = false) : encoder(k, canonical), hll(hll) {}
+
+    void beginRecord(const std::string &) { encoder.reset(); }
+
+    void sequence(const char *data, size_t length) { encoder.feed(data, length, *this); }
+
+    // Llamado por Kmer128Encoder con cada k-mer
+    void operator()(const Kmer128 &kmer) { hll.addKmer(kmer); }
+
+    bool endRecord() { return true; }
+};
+
+// K-mers que entran al HyperLogLog (k <= 32): todos, solo los minimizadores
+// de ventanas de `parameter` bases o solo los syncmers cerrados de s-mers de
+// largo `parameter`. Muestrear reduce las actualizaciones de registros en el
+// factor de la densidad, y el Jaccard estimado pasa a ser el del espacio
+// muestreado.
+struct KmerSampling {
+    enum Mode { AllKmers, Minimizers, Syncmers };
+
+    Mode mode;
+    int parameter;
+
+    KmerSampling() : mode(AllKmers), parameter(0) {}
+    KmerSampling(Mode mode, int parameter) : mode(mode), parameter(parameter) {}
+
+    // Jaccard de los k-mers a partir del Jaccard estimado entre sketches
+    // muestreados (ver kmerJaccardFromSampled)
+    double correctJaccard(double sampledJaccard, int k) const {
+        if (mode != Minimizers) return sampledJaccard;
+        return kmerJaccardFromSampled(sampledJaccard, k, minimizerContextLength(k, parameter));
+    }
+
+    // Igual para la contencion (ver kmerContainmentFromSampled)
+    double correctContainment(double sampledContainment, int k) const {
+        if (mode != Minimizers) return sampledContainment;
+        return kmerContainmentFromSampled(sampledContainment, k, minimizerContextLength(k, parameter));
+    }
+};
+
+// Handler que inserta en el HyperLogLog solo los k-mers elegidos por un
+// MinimizerFinder o un SyncmerFinder
+template <typename Sampler>
+class SampledSketchBuilder {
+private:
+    Sampler sampler;
+    HyperLogLog &hll;
+
+public:
+    SampledSketchBuilder(const Sampler &sampler, HyperLogLog &hll) : sampler(sampler), hll(hll) {}
+
+    void beginRecord(const std::string &) { sampler.reset(); }
+
+    void sequence(const char *data, size_t length) { sampler.feed(data, length, *this); }
+
+    // Llamado por el muestreador con cada k-mer elegido
+    void operator()(const Minimizer &kmer) { hll.addKmer(kmer.kmer); }
+
+    bool endRecord() { return true; }
+};
+
+// Construir el sketch de todos los registros de un archivo FASTA/FASTQ
+// (plano o .gz). Retorna false si el archivo no se pudo leer.
+// Con filtro de abundancia k debe ser <= 32.
+bool sketchFile(const std::string &filename, int k, HyperLogLog &hll, AbundanceFilter *filter = nullptr,
+                bool canonical = false);
+
+// Igual, insertando solo los k-mers elegidos por `sampling` (k <= 32)
+bool sketchFile(const std::string &filename, int k, HyperLogLog &hll, const KmerSampling &sampling,
+                bool canonical = false);
+
+// Igual, llenando sketches[i] con los k-mers de largo ks[i] en una sola pasada.
+// Los k mayores que 32 (hasta 64) solo se admiten de a uno.
+bool sketchFile(const std::string &filename, const std::vector<int> &ks,
+                const std::vector<HyperLogLog *> &sketches, bool canonical = false);
+
+// Igual que sketchFile, pero el archivo mapeado se divide en trozos de
+// `chunkBases` bytes (con max(ks)-1 bases de traslape) que se encolan en
+// `pool` sin recorrerlo antes, asi un registro enorme se procesa en paralelo
+// desde el principio; cada trozo llena sketches propios que luego se fusionan
+// en `sketches`. La funcion retorna apenas encola los trozos: los sketches
+// estan completos cuando termina pool.wait(). Los archivos .gz y FASTQ se
+// procesan en forma secuencial.
+bool sketchFileChunked(const std::string &filename, const std::vector<int> &ks,
+                       const std::vector<HyperLogLog *> &sketches,
+                       ThreadPool &pool, size_t chunkBases, bool canonical = false);
+
+#endif
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "bbitminhash.h"
+#include "minhash.h"
+#include "syncmer.h"
+
+// Pruebas de los sketches del comparador de genomas. Cada prueba retorna false
+// e informa en cerr si falla; el programa termina con 1 si alguna fallo.
+
+static bool check(bool condition, const char *what) {
+    if (!condition) std::cerr << "FALLO: " << what << std::endl;
+    return condition;
+}
+
+// Con 2^24 bins y unos pocos miles de k-mers casi todos los bins quedan vacios:
+// la densificacion debe terminar pronto y coincidir entre sketches iguales
+static bool testSparseDensification() {
+    MinHash a(24), b(24);
+    for (uint64_t code = 0; code < 3000; ++code) {
+        a.addKmer(code);
+        b.addKmer(code);
+    }
+    auto start = std::chrono::steady_clock::now();
+    a.finish();
+    b.finish();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double similarity = 0.0;
+    return check(seconds < 20.0, "densificar un MinHash disperso de 2^24 bins") &
+           check(a.jaccard(b, similarity) && similarity == 1.0, "Jaccard de dos MinHash dispersos iguales");
+}
+
+// Sketches con distinta cantidad de bins (o firmas con distinto b) se
+// rechazan en vez de leer fuera del mas corto
+static bool testMinHashMismatch() {
+    MinHash small(8), large(12);
+    for (uint64_t code = 0; code < 1000; ++code) {
+        small.addKmer(code);
+        large.addKmer(code);
+    }
+    small.finish();
+    large.finish();
+    BBitMinHash oneBit(large, 1), twoBits(large, 2), fewerBins(small, 1);
+
+    double similarity = -1.0;
+    size_t equal = 0;
+    bool ok = check(!small.jaccard(large, similarity) && !large.jaccard(small, similarity),
+                    "Jaccard entre MinHash de distinta cantidad de bins");
+    ok &= check(!large.merge(small), "merge de MinHash de distinta cantidad de bins");
+    ok &= check(!oneBit.jaccard(twoBits, similarity) && !oneBit.matches(twoBits, equal),
+                "comparar firmas de b bits con distinto b");
+    ok &= check(!oneBit.jaccard(fewerBins, similarity) && !fewerBins.matches(oneBit, equal),
+                "comparar firmas de b bits con distinta cantidad de bins");
+    ok &= check(similarity == -1.0, "una comparacion rechazada no escribe el resultado");
+    ok &= check(oneBit.jaccard(oneBit, similarity) && similarity == 1.0, "Jaccard de una firma de b bits consigo misma");
+    return ok;
+}
+
+// Syncmers cerrados canonicos de una secuencia, ordenados y sin repetir
+static std::vector<uint64_t> closedSyncmers(const std::string &sequence, int k, int s) {
+    std::vector<uint64_t> kmers;
+    SyncmerFinder finder(k, s, ClosedSyncmer, 0, true);
+    auto sink = [&kmers](const Syncmer &syncmer) { kmers.push_back(syncmer.kmer); };
+    finder.feed(sequence.data(), sequence.size(), sink);
+    std::sort(kmers.begin(), kmers.end());
+    kmers.erase(std::unique(kmers.begin(), kmers.end()), kmers.end());
+    return kmers;
+}
+
+// Una secuencia y su reverso complementario eligen los mismos syncmers
+// cerrados canonicos, tambien con s-mers repetidos que empatan en el orden
+static bool testClosedSyncmerStrands() {
+    std::mt19937 random(7);
+    std::string forward(20000, 'A');
+    for (auto &base : forward) base = "ACGT"[random() & 3];
+    std::string reverse(forward.rbegin(), forward.rend());
+    for (auto &base : reverse) base = base == 'A' ? 'T' : base == 'C' ? 'G' : base == 'G' ? 'C' : 'A';
+
+    bool ok = true;
+    for (int s : { 4, 7, 11 }) {
+        ok &= check(closedSyncmers(forward, 21, s) == closedSyncmers(reverse, 21, s),
+                    "syncmers cerrados canonicos de ambas hebras");
+    }
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    ok &= testSparseDensification();
+    ok &= testMinHashMismatch();
+    ok &= testClosedSyncmerStrands();
+    return ok ? 0 : 1;
+}
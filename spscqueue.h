@@ -0,0 +1,61 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Cola circular sin locks para exactamente un productor y un consumidor.
+// La capacidad es fija (se redondea a potencia de 2); cuando esta llena el
+// productor espera, lo que limita la memoria y frena a la etapa mas rapida.
+// head y tail van en lineas de cache distintas para que productor y
+// consumidor no se invaliden mutuamente.
+template <typename T>
+class SpscQueue {
+private:
+    std::vector<T> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head;  // Lo escribe solo el consumidor
+    alignas(64) std::atomic<size_t> tail;  // Lo escribe solo el productor
+
+    SpscQueue(const SpscQueue &);
+    SpscQueue &operator=(const SpscQueue &);
+
+public:
+    explicit SpscQueue(size_t capacity) : head(0), tail(0) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    // Retorna false si la cola esta llena (value no se modifica)
+    bool tryPush(T &value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == slots.size()) return false;
+        slots[t & mask] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Retorna false si la cola esta vacia
+    bool tryPop(T &value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (tail.load(std::memory_order_acquire) == h) return false;
+        value = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Versiones bloqueantes: ceden el procesador mientras esperan
+    void push(T &value) {
+        while (!tryPush(value)) std::this_thread::yield();
+    }
+
+    void pop(T &value) {
+        while (!tryPop(value)) std::this_thread::yield();
+    }
+};
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef SYNCMER_H
+#define SYNCMER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "kmer.h"
+#include "minimizer.h"
+
+// Syncmer elegido: misma forma que un minimizador (k-mer y posicion)
+typedef Minimizer Syncmer;
+
+// Abierto: el s-mer minimo del k-mer esta en `offset`. Cerrado: esta en el
+// primer o en el ultimo lugar. Si hay empates basta con que uno de los
+// minimos este en ese lugar.
+enum SyncmerKind { OpenSyncmer, ClosedSyncmer };
+
+// Muestreo de k-mers por syncmers (k <= 32, s <= k). A diferencia de los
+// minimizadores la decision depende solo del k-mer y no de sus vecinos: se
+// ordenan sus k - s + 1 s-mers con Order::order y se elige si el minimo cae
+// en el lugar pedido. Los empates no favorecen a ningun lado, asi que la
+// eleccion no cambia al leer el k-mer en la otra hebra. Densidad
+// esperada con un orden aleatorio: 1 / (k - s + 1) abiertos, 2 / (k - s + 1)
+// cerrados.
+//
+// Se trabaja por tramos: primero se calculan los ordenes de los s-mers del
+// tramo con un codigo rodante y despues cada k-mer toma minimos sobre una
+// ventana de largo fijo sin saltos, que el compilador puede vectorizar y que
+// se podria repartir entre hilos. Cuesta O(k - s) por k-mer en lugar del O(1)
+// amortizado de la cola de MinimizerFinder, pero para s cercano a k es poco y
+// no hay ramas impredecibles. Los k-mers no cruzan bases ambiguas.
+template <typename Order>
+class BasicSyncmerFinder {
+private:
+    int k, s;
+    size_t span;                    // k - s: indice del ultimo s-mer del k-mer
+    size_t offset;                  // Lugar del minimo en los abiertos
+    bool closed;
+    bool canonical;
+    uint64_t smerMask, kmerMask;
+    uint64_t smerCode, kmerCode;
+    uint64_t smerReverse, kmerReverse;
+    int valid;                      // Bases validas consecutivas
+    uint64_t position;              // Posicion de la proxima base en el registro
+    uint64_t runStart;              // Posicion del s-mer orders[0]
+    std::vector<uint64_t> orders;   // Ordenes de los s-mers del tramo actual
+    std::vector<uint64_t> kmers;    // k-mer que termina en cada s-mer (alineado con orders)
+
+    // s-mers por tramo: acota la memoria y mantiene los ordenes en cache
+    static const size_t blockSmers = 1 << 12;
+
+    static uint64_t maskFor(int length) {
+        return length == 32 ? ~uint64_t(0) : (uint64_t(1) << (2 * length)) - 1;
+    }
+
+    // Minimo de orders[from, to), vacio = maximo
+    uint64_t minimum(size_t from, size_t to) const {
+        uint64_t best = ~uint64_t(0);
+        for (size_t i = from; i < to; ++i) {
+            uint64_t order = orders[i];
+            best = order < best ? order : best;
+        }
+        return best;
+    }
+
+    // Evaluar los k-mers completos del tramo y dejar solo los span s-mers
+    // que comparte con el siguiente k-mer
+    template <typename Sink>
+    void flush(Sink &sink) {
+        size_t n = orders.size();
+        for (size_t e = span; e < n; ++e) {
+            size_t first = e - span;
+            bool selected;
+            if (closed) {
+                uint64_t inner = minimum(first + 1, e);
+                uint64_t head = orders[first], tail = orders[e];
+                selected = (head <= inner) | (tail <= inner);
+            } else {
+                uint64_t at = orders[first + offset];
+                selected = (at <= minimum(first, first + offset)) & (at <= minimum(first + offset + 1, e + 1));
+            }
+            if (selected) {
+                Syncmer syncmer = { kmers[e], runStart + first };
+                sink(syncmer);
+            }
+        }
+        if (n > span) {
+            orders.erase(orders.begin(), orders.end() - span);
+            kmers.erase(kmers.begin(), kmers.end() - span);
+            runStart += n - span;
+        }
+    }
+
+public:
+    // `offset` solo se usa en los abiertos (0 <= offset <= k - s). Con
+    // `canonical` los s-mers y los k-mers se toman en su forma canonica; los
+    // cerrados (y los abiertos con el s-mer del medio) eligen entonces los
+    // mismos k-mers en ambas hebras.
+    BasicSyncmerFinder(int k, int s, SyncmerKind kind, int offset = 0, bool canonical = false)
+        : k(k), s(s), span(static_cast<size_t>(k - s)), offset(static_cast<size_t>(offset)),
+          closed(kind == ClosedSyncmer), canonical(canonical), smerMask(maskFor(s)), kmerMask(maskFor(k)) {
+        reset();
+    }
+
+    // Olvidar las bases anteriores (inicio de un nuevo registro)
+    void reset() {
+        smerCode = kmerCode = 0;
+        smerReverse = kmerReverse = 0;
+        valid = 0;
+        position = 0;
+        runStart = 0;
+        orders.clear();
+        kmers.clear();
+    }
+
+    // Procesar una base (codigo de baseCode, mayor que 3 si es ambigua). Los
+    // syncmers se entregan por tramos, en orden de posicion; llamar finish()
+    // al terminar para recibir los pendientes.
+    template <typename Sink>
+    void push(uint64_t base, Sink &sink) {
+        uint64_t current = position++;
+        if (base > 3) {
+            flush(sink);
+            valid = 0;
+            orders.clear();
+            kmers.clear();
+            return;
+        }
+        smerCode = ((smerCode << 2) | base) & smerMask;
+        kmerCode = ((kmerCode << 2) | base) & kmerMask;
+        smerReverse = (smerReverse >> 2) | ((3 - base) << (2 * s - 2));
+        kmerReverse = (kmerReverse >> 2) | ((3 - base) << (2 * k - 2));
+        valid += valid < k;
+        if (valid < s) return;
+        if (orders.empty()) runStart = current + 1 - s;
+        uint64_t smer = canonical && smerReverse < smerCode ? smerReverse : smerCode;
+        orders.push_back(Order::order(smer));
+        kmers.push_back(canonical && kmerReverse < kmerCode ? kmerReverse : kmerCode);
+        if (orders.size() == span + blockSmers) flush(sink);
+    }
+
+    // Procesar un tramo en ASCII llamando sink(syncmer) con cada k-mer
+    // elegido, en orden de posicion
+    template <typename Sink>
+    void feed(const char *data, size_t length, Sink &sink) {
+        const unsigned char *bases = reinterpret_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < length; ++i) {
+            push(baseCode[bases[i]], sink);
+        }
+        flush(sink);
+    }
+
+    // Entregar los syncmers pendientes despues de una serie de push()
+    template <typename Sink>
+    void finish(Sink &sink) { flush(sink); }
+};
+
+typedef BasicSyncmerFinder<MINIMIZER_ORDER> SyncmerFinder;
+
+#endif
@@ -0,0 +1,102 @@
+#include "threadpool.h"
+
+// Pool e indice del hilo actual, para que submit() desde una tarea use la
+// cola local
+static thread_local ThreadPool *currentPool = nullptr;
+static thread_local unsigned currentIndex = 0;
+
+ThreadPool::ThreadPool(unsigned count) : queued(0), pending(0), nextQueue(0), stopping(false) {
+    if (count == 0) {
+        count = std::thread::hardware_concurrency();
+        if (count == 0) count = 1;
+    }
+    for (unsigned i = 0; i < count; ++i) {
+        queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+    }
+    for (unsigned i = 0; i < count; ++i) {
+        threads.push_back(std::thread(&ThreadPool::run, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        stopping = true;
+    }
+    idle.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    unsigned index = currentPool == this ? currentIndex
+                                         : nextQueue++ % static_cast<unsigned>(queues.size());
+    ++pending;
+    // Contar la tarea antes de publicarla: otro hilo puede robarla y
+    // descontarla apenas esta en la cola, y `queued` no debe bajar de 0
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        ++queued;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    idle.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(idleMutex);
+    finished.wait(lock, [this] { return pending == 0; });
+}
+
+bool ThreadPool::popLocal(unsigned index, Task &task) {
+    std::lock_guard<std::mutex> lock(queues[index]->mutex);
+    if (queues[index]->tasks.empty()) return false;
+    task = std::move(queues[index]->tasks.back());
+    queues[index]->tasks.pop_back();
+    return true;
+}
+
+// Recorrer las demas colas empezando por la vecina
+bool ThreadPool::steal(unsigned index, Task &task) {
+    size_t count = queues.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        WorkQueue &victim = *queues[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(unsigned index) {
+    currentPool = this;
+    currentIndex = index;
+
+    for (;;) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                --queued;
+            }
+            task();
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                finished.notify_all();
+            }
+            continue;
+        }
+
+        // Dormir hasta que alguien encole una tarea
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idle.wait(lock, [this] { return queued > 0 || stopping; });
+        if (stopping && queued == 0) return;
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de hilos con robo de trabajo. Cada hilo tiene su propia cola: saca
+// tareas del final de la suya (LIFO, datos aun en cache) y cuando se queda sin
+// trabajo roba del principio de la cola de otro hilo (FIFO, las tareas mas
+// antiguas y normalmente mas grandes). Asi ningun nucleo queda ocioso aunque
+// las tareas tengan tamaños muy distintos, como genomas de kilobases junto a
+// genomas de decenas de megabases.
+class ThreadPool {
+public:
+    typedef std::function<void()> Task;
+
+    // threads = 0 usa un hilo por nucleo
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    // Encolar una tarea. Desde dentro de una tarea del pool se encola en la
+    // cola del propio hilo; desde afuera se reparte en round-robin.
+    void submit(Task task);
+
+    // Esperar a que terminen todas las tareas, incluidas las que se encolaron
+    // desde otras tareas
+    void wait();
+
+    unsigned size() const { return static_cast<unsigned>(threads.size()); }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue> > queues;
+    std::vector<std::thread> threads;
+
+    std::mutex idleMutex;
+    std::condition_variable idle;      // Hilos esperando trabajo
+    std::condition_variable finished;  // wait() esperando que pending llegue a 0
+    size_t queued;                     // Tareas en colas o por entrar (protegido por idleMutex)
+    std::atomic<size_t> pending;       // Tareas encoladas o en ejecucion
+    std::atomic<unsigned> nextQueue;
+    bool stopping;
+
+    void run(unsigned index);
+    bool popLocal(unsigned index, Task &task);
+    bool steal(unsigned index, Task &task);
+
+    ThreadPool(const ThreadPool &);
+    ThreadPool &operator=(const ThreadPool &);
+};
+
+#endif
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "vptree.h"
+
+static const char treeMagic[8] = { 'H', 'L', 'L', 'V', 'P', 'T', '0', '2' };
+
+// Nodos con al menos esta cantidad de referencias calculan sus distancias en
+// paralelo, en bloques de este tamaño
+static const size_t parallelBlock = 64;
+
+template <typename T>
+static void writeValue(std::ostream &out, T value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool readValue(std::istream &in, T &value) {
+    in.read(reinterpret_cast<char *>(&value), sizeof(value));
+    return static_cast<bool>(in);
+}
+
+void VpTree::build(const SketchSearcher &searcher, ThreadPool &pool) {
+    std::vector<std::pair<double, uint32_t> > items(searcher.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        items[i] = std::make_pair(0.0, static_cast<uint32_t>(i));
+    }
+    nodes.clear();
+    nodes.reserve(items.size());
+    build(searcher, items, 0, items.size(), pool);
+}
+
+// Construye el subarbol de items[begin, end) y retorna su indice en `nodes`
+int32_t VpTree::build(const SketchSearcher &searcher, std::vector<std::pair<double, uint32_t> > &items,
+                      size_t begin, size_t end, ThreadPool &pool) {
+    if (begin == end) return -1;
+
+    // El punto de vista es el elemento del medio, para no depender del orden
+    // de la base
+    std::swap(items[begin], items[begin + (end - begin) / 2]);
+    uint32_t vantage = items[begin].second;
+    int32_t index = static_cast<int32_t>(nodes.size());
+    Node node = { vantage, 0.0, -1, -1 };
+    nodes.push_back(node);
+    if (end - begin == 1) return index;
+
+    // Distancias de los demas al punto de vista
+    const HyperLogLog &sketch = searcher.sketch(vantage);
+    double cardinality = searcher.cardinality(vantage);
+    auto measure = [&searcher, &items, &sketch, cardinality](size_t from, size_t to) {
+        for (size_t i = from; i < to; ++i) {
+            items[i].first = 1.0 - searcher.similarity(sketch, cardinality, items[i].second);
+        }
+    };
+    if (end - begin - 1 >= 2 * parallelBlock) {
+        for (size_t start = begin + 1; start < end; start += parallelBlock) {
+            size_t stop = std::min(start + parallelBlock, end);
+            pool.submit([measure, start, stop] { measure(start, stop); });
+        }
+        pool.wait();
+    } else {
+        measure(begin + 1, end);
+    }
+
+    // La mitad mas cercana queda adentro; el radio es la menor distancia de
+    // afuera
+    size_t middle = begin + 1 + (end - begin - 1) / 2;
+    std::nth_element(items.begin() + begin + 1, items.begin() + middle, items.begin() + end);
+    nodes[index].radius = items[middle].first;
+
+    int32_t inside = build(searcher, items, begin + 1, middle, pool);
+    int32_t outside = build(searcher, items, middle, end, pool);
+    nodes[index].inside = inside;
+    nodes[index].outside = outside;
+    return index;
+}
+
+bool VpTree::save(const std::string &filename) const {
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    if (!out) return false;
+
+    out.write(treeMagic, sizeof(treeMagic));
+    writeHashPolicy(out);
+    writeValue<uint64_t>(out, nodes.size());
+    for (const auto &node : nodes) {
+        writeValue<uint32_t>(out, node.reference);
+        writeValue<double>(out, node.radius);
+        writeValue<int32_t>(out, node.inside);
+        writeValue<int32_t>(out, node.outside);
+    }
+    return static_cast<bool>(out);
+}
+
+bool VpTree::load(const std::string &filename, uint64_t expectedReferences) {
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    if (!in) return false;
+
+    char magic[sizeof(treeMagic)];
+    uint64_t count;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, treeMagic, sizeof(magic)) != 0) return false;
+    if (!readHashPolicy(in)) return false;
+    if (!readValue(in, count) || count != expectedReferences) return false;
+
+    // build() numera cada hijo despues de su padre, asi que un hijo valido es
+    // -1 o un nodo posterior (y no puede haber ciclos)
+    nodes.resize(count);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        Node &node = nodes[i];
+        if (!readValue(in, node.reference) || !readValue(in, node.radius) ||
+            !readValue(in, node.inside) || !readValue(in, node.outside)) {
+            return false;
+        }
+        if (node.reference >= count) return false;
+        if (node.inside != -1 && (node.inside <= int64_t(i) || node.inside >= int64_t(count))) return false;
+        if (node.outside != -1 && (node.outside <= int64_t(i) || node.outside >= int64_t(count))) return false;
+    }
+    return true;
+}
+
+std::vector<SearchHit> VpTree::nearest(const SketchSearcher &searcher, const HyperLogLog &query, size_t count,
+                                       size_t &comparisons) const {
+    BoundedHeap best(std::min(count, nodes.size()));
+    comparisons = 0;
+    if (nodes.empty() || count == 0) return best.take();
+
+    double queryCardinality = query.estimate();
+
+    // Pila de nodos por visitar, cada uno con una cota inferior de la
+    // distancia de la consulta a cualquier referencia de su subarbol
+    std::vector<std::pair<int32_t, double> > pending(1, std::make_pair(0, 0.0));
+
+    // tau: distancia del k-esimo mejor, o infinita mientras no haya k
+    auto tau = [&best]() { return best.full() ? 1.0 - best.worst().similarity : 2.0; };
+
+    while (!pending.empty()) {
+        std::pair<int32_t, double> next = pending.back();
+        pending.pop_back();
+        if (next.second > tau()) continue;  // tau bajo desde que se apilo
+
+        const Node &node = nodes[next.first];
+        SearchHit hit = { node.reference, searcher.similarity(query, queryCardinality, node.reference) };
+        ++comparisons;
+        best.offer(hit);
+        double distance = 1.0 - hit.similarity;
+
+        // Adentro d(q, x) >= d - mu y afuera d(q, x) >= mu - d. El lado donde
+        // cae la consulta queda arriba en la pila para visitarse primero.
+        double insideBound = std::max(next.second, distance - node.radius);
+        double outsideBound = std::max(next.second, node.radius - distance);
+        if (distance < node.radius) {
+            if (node.outside >= 0 && outsideBound <= tau()) pending.push_back(std::make_pair(node.outside, outsideBound));
+            if (node.inside >= 0) pending.push_back(std::make_pair(node.inside, insideBound));
+        } else {
+            if (node.inside >= 0 && insideBound <= tau()) pending.push_back(std::make_pair(node.inside, insideBound));
+            if (node.outside >= 0) pending.push_back(std::make_pair(node.outside, outsideBound));
+        }
+    }
+    return best.take();
+}
@@ -0,0 +1,59 @@
+#ifndef VPTREE_H
+#define VPTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "search.h"
+#include "threadpool.h"
+
+// Arbol de puntos de vista (vantage-point tree) sobre las referencias de una
+// SketchDatabase con la distancia de Jaccard d = 1 - J, que es una metrica.
+// Cada nodo tiene una referencia v y un radio mu (la mediana de las
+// distancias de su subarbol a v): las mas cercanas van adentro y el resto
+// afuera. Al buscar los k vecinos con la distancia tau del k-esimo mejor, por
+// la desigualdad triangular un lado se puede saltar completo si
+// d(q, v) + tau < mu (afuera) o d(q, v) - tau > mu (adentro).
+//
+// Las distancias se calculan con el Jaccard estimado, que cumple la
+// desigualdad triangular solo de forma aproximada, asi que la poda puede
+// perder un vecino cuya distancia estimada esta muy cerca de tau.
+//
+// Formato binario: firma "HLLVPT02", politica de hash (ver writeHashPolicy),
+// cantidad de nodos (uint64) y por nodo
+// la referencia (uint32), el radio (double) y los indices de los hijos
+// adentro y afuera (int32, -1 si no hay).
+class VpTree {
+private:
+    struct Node {
+        uint32_t reference;
+        double radius;
+        int32_t inside;
+        int32_t outside;
+    };
+
+    std::vector<Node> nodes;  // nodes[0] es la raiz
+
+    int32_t build(const SketchSearcher &searcher, std::vector<std::pair<double, uint32_t> > &items,
+                  size_t begin, size_t end, ThreadPool &pool);
+
+public:
+    void build(const SketchSearcher &searcher, ThreadPool &pool);
+
+    bool save(const std::string &filename) const;
+
+    // Retorna false si el archivo no existe, esta truncado, usa otra politica
+    // de hash o no es un arbol sobre una base de `expectedReferences` sketches
+    bool load(const std::string &filename, uint64_t expectedReferences);
+
+    size_t size() const { return nodes.size(); }
+
+    // Las `count` referencias mas parecidas, de la mejor a la peor.
+    // `comparisons` recibe cuantas referencias se compararon.
+    std::vector<SearchHit> nearest(const SketchSearcher &searcher, const HyperLogLog &query, size_t count,
+                                   size_t &comparisons) const;
+};
+
+#endif